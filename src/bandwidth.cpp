@@ -0,0 +1,151 @@
+// bandwidth.cpp
+// STREAM-like bandwidth probes for the roofline report.
+
+#include "bandwidth.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <vector>
+
+#include "philox.h"
+#include "sysinfo.h"
+
+using Clock = std::chrono::steady_clock;
+
+static constexpr uint64_t kProbeKeys = 16 * 1024 * 1024; // keys per timed run, at least
+static constexpr int kProbeRuns = 3;                     // best of
+
+static volatile uint32_t gSink; // keeps the read probe's sum alive
+
+// 'p', through a volatile copy: the compiler can't see that every call gets the same buffer, so it
+// can't hoist a kernel's work out of the repeat loop
+template <typename T> static T *opaque(T *p)
+{
+    T *volatile q = p;
+    return q;
+}
+
+// GB/s of 'kernel' moving 'bytes' per call: best of kProbeRuns runs of enough calls to cover
+// kProbeKeys keys.
+template <typename Kernel> static double bestBandwidth(uint32_t n, double bytes, Kernel kernel)
+{
+    uint64_t calls = std::max<uint64_t>(1, kProbeKeys / n);
+    double best = 0;
+    for (int run = 0; run < kProbeRuns; ++run)
+    {
+        auto t0 = Clock::now();
+        for (uint64_t c = 0; c < calls; ++c)
+            kernel();
+        double seconds = std::chrono::duration<double>(Clock::now() - t0).count();
+        best = std::max(best, bytes * calls / seconds / 1e9);
+    }
+    return best;
+}
+
+BandwidthProbe measureBandwidth(uint32_t n)
+{
+    std::vector<uint32_t> src(n), dst(n);
+    Philox rng(4321, 0, 0);
+    for (uint32_t &k : src)
+        k = rng();
+    dst = src; // every page mapped before timing
+
+    BandwidthProbe probe;
+    double keyBytes = double(n) * sizeof(uint32_t);
+
+    probe.read = bestBandwidth(n, keyBytes, [&] {
+        const uint32_t *s = opaque(src.data());
+        uint32_t sum = 0;
+        for (uint32_t i = 0; i < n; ++i)
+            sum += s[i];
+        gSink = sum;
+    });
+    probe.write = bestBandwidth(n, keyBytes, [&] {
+        uint32_t *d = opaque(dst.data());
+        for (uint32_t i = 0; i < n; ++i)
+            d[i] = i;
+    });
+    probe.copy = bestBandwidth(
+        n, 2 * keyBytes, [&] { std::memcpy(opaque(dst.data()), opaque(src.data()), n * sizeof(uint32_t)); });
+
+    // the scatter of a radix pass: bucket offsets from a histogram, then every key to the next slot
+    // of its bucket. Resetting the offsets is timed too, as a radix pass pays for its prefix sum.
+    for (int f = 0; f < kScatterProbes; ++f)
+    {
+        uint32_t mask = kScatterFanouts[f] - 1;
+        std::vector<uint32_t> start(kScatterFanouts[f] + 1, 0), next(kScatterFanouts[f]);
+        for (uint32_t k : src)
+            ++start[(k & mask) + 1];
+        for (uint32_t b = 0; b < kScatterFanouts[f]; ++b)
+            start[b + 1] += start[b];
+
+        probe.scatter[f] = bestBandwidth(n, 2 * keyBytes, [&] {
+            std::memcpy(next.data(), start.data(), next.size() * sizeof(uint32_t));
+            const uint32_t *s = opaque(src.data());
+            uint32_t *d = opaque(dst.data()), *o = next.data();
+            for (uint32_t i = 0; i < n; ++i)
+                d[o[s[i] & mask]++] = s[i];
+        });
+    }
+    return probe;
+}
+
+double scatterBandwidth(const BandwidthProbe &probe, uint32_t digitBits)
+{
+    int f = digitBits <= 8 ? 0 : digitBits <= 11 ? 1 : 2;
+    return probe.scatter[f];
+}
+
+BandwidthHog::BandwidthHog(uint32_t threads) : threads_(threads)
+{
+    size_t bytes = std::max<size_t>(4 * lastLevelCacheBytes(), size_t(64) << 20);
+    buffers_.resize(threads);
+    for (std::vector<uint32_t> &buffer : buffers_)
+        buffer.assign(bytes / sizeof(uint32_t), 1); // every page mapped up front
+}
+
+BandwidthHog::~BandwidthHog()
+{
+    if (running_)
+        stop();
+}
+
+void BandwidthHog::start()
+{
+    bytes_ = 0;
+    running_ = true;
+    started_ = Clock::now();
+    for (std::vector<uint32_t> &buffer : buffers_)
+    {
+        pool_.emplace_back([this, &buffer] {
+            size_t half = buffer.size() / 2;
+            uint32_t *a = buffer.data(), *b = a + half;
+            while (running_.load(std::memory_order_relaxed))
+            {
+                std::memcpy(opaque(b), opaque(a), half * sizeof(uint32_t));
+                std::swap(a, b);
+                bytes_.fetch_add(2 * half * sizeof(uint32_t), std::memory_order_relaxed);
+            }
+        });
+    }
+}
+
+double BandwidthHog::lap()
+{
+    Clock::time_point now = Clock::now();
+    double seconds = std::chrono::duration<double>(now - started_).count();
+    uint64_t bytes = bytes_.exchange(0);
+    started_ = now;
+    return seconds > 0 ? bytes / seconds / 1e9 : 0.0;
+}
+
+double BandwidthHog::stop()
+{
+    running_ = false;
+    for (std::thread &th : pool_)
+        th.join();
+    pool_.clear();
+    double seconds = std::chrono::duration<double>(Clock::now() - started_).count();
+    return seconds > 0 ? bytes_ / seconds / 1e9 : 0.0;
+}
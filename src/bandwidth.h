@@ -0,0 +1,55 @@
+#pragma once
+
+// STREAM-like bandwidth probes, for the roofline report (--mode=roofline): what one thread can read,
+// write, copy and scatter over a working set the size of a sort's buffers.
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+// Bucket counts of the scatter probe: the fan-outs of 8-, 11- and 16-bit digits.
+static constexpr uint32_t kScatterFanouts[] = {256, 2048, 65536};
+static constexpr int kScatterProbes = 3;
+
+// Bandwidth in GB/s (1e9 bytes per second) of every probe. Each counts the bytes the kernel asks
+// for -- 4 per key read and 4 per key written -- not write-allocate traffic.
+struct BandwidthProbe
+{
+    double read = 0;  // sum of n keys
+    double write = 0; // fill n keys
+    double copy = 0;  // memcpy of n keys
+    double scatter[kScatterProbes] = {}; // radix scatter of n random keys, per kScatterFanouts
+};
+
+// Runs every probe over buffers of 'n' 32-bit keys (each probe uses one or two of them), repeating
+// enough to time reliably; the best of a few runs.
+BandwidthProbe measureBandwidth(uint32_t n);
+
+// Scatter bandwidth for 2^digitBits buckets: the probe with the nearest fan-out.
+double scatterBandwidth(const BandwidthProbe &probe, uint32_t digitBits);
+
+// Background memory traffic for --mode=contention: 'threads' threads each copying back and forth
+// between the halves of a buffer of their own (4x the last-level cache, at least 64 MB) from
+// start() until stop(). stop() and lap() return the GB/s they moved together (reads plus writes)
+// since start() or the last lap(); lap() keeps them running and begins the next window.
+class BandwidthHog
+{
+  public:
+    explicit BandwidthHog(uint32_t threads);
+    ~BandwidthHog();
+
+    void start();
+    double lap();
+    double stop();
+    uint32_t threads() const { return threads_; }
+
+  private:
+    uint32_t threads_;
+    std::vector<std::vector<uint32_t>> buffers_;
+    std::vector<std::thread> pool_;
+    std::atomic<bool> running_{false};
+    std::atomic<uint64_t> bytes_{0};
+    std::chrono::steady_clock::time_point started_;
+};
@@ -0,0 +1,108 @@
+// cache_state.cpp
+// Putting a sort's input in a known cache state before it is timed.
+
+#include "cache_state.h"
+
+#include <cstdint>
+#include <iostream>
+#include <memory>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#include <immintrin.h>
+#define CACHE_STATE_X86 1
+#else
+#define CACHE_STATE_X86 0
+#endif
+
+#include "sysinfo.h"
+
+static constexpr size_t kLineBytes = 64;
+static constexpr size_t kDefaultEvictBytes = 64u << 20;
+
+static const CacheState kStates[] = {CacheState::Batch, CacheState::Warm, CacheState::Cold, CacheState::Flush};
+
+const char *cacheStateName(CacheState state)
+{
+    switch (state)
+    {
+    case CacheState::Warm:
+        return "warm";
+    case CacheState::Cold:
+        return "cold";
+    case CacheState::Flush:
+        return "flush";
+    default:
+        return "batch";
+    }
+}
+
+bool selectCacheStates(const std::string &list, std::vector<CacheState> &out)
+{
+    out.clear();
+    size_t pos = 0;
+    while (pos <= list.size())
+    {
+        size_t comma = list.find(',', pos);
+        std::string name = list.substr(pos, comma == std::string::npos ? std::string::npos : comma - pos);
+        pos = comma == std::string::npos ? list.size() + 1 : comma + 1;
+
+        bool found = false;
+        for (CacheState state : kStates)
+        {
+            if (name == "all" || name == cacheStateName(state))
+            {
+                out.push_back(state);
+                found = true;
+            }
+        }
+        if (!found)
+        {
+            std::cerr << "unknown cache state '" << name << "' (batch, warm, cold, flush)\n";
+            return false;
+        }
+    }
+    return !out.empty();
+}
+
+void warmRange(const void *data, size_t bytes)
+{
+    // volatile reads: the compiler can't drop them
+    const volatile uint8_t *p = static_cast<const volatile uint8_t *>(data);
+    for (size_t i = 0; i < bytes; i += kLineBytes)
+        (void)p[i];
+    if (bytes)
+        (void)p[bytes - 1];
+}
+
+void flushRange(const void *data, size_t bytes)
+{
+#if CACHE_STATE_X86
+    const char *p = static_cast<const char *>(data);
+    for (size_t i = 0; i < bytes; i += kLineBytes)
+        _mm_clflush(p + i);
+    if (bytes)
+        _mm_clflush(p + bytes - 1);
+    _mm_mfence();
+#else
+    (void)data;
+    (void)bytes;
+    evictCaches();
+#endif
+}
+
+void evictCaches()
+{
+    static size_t size = 0;
+    static std::unique_ptr<uint8_t[]> buffer;
+    if (!buffer)
+    {
+        size_t llc = lastLevelCacheBytes();
+        size = llc ? 2 * llc : kDefaultEvictBytes;
+        buffer.reset(new uint8_t[size]()); // zeroed, which also maps every page now
+    }
+
+    // read-modify-write, so the lines we leave behind are ours and dirty
+    volatile uint8_t *p = buffer.get();
+    for (size_t i = 0; i < size; i += kLineBytes)
+        p[i] = uint8_t(p[i] + 1);
+}
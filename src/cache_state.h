@@ -0,0 +1,34 @@
+#pragma once
+
+// Cache state of a sort's input when the timer starts (--cache). Back-to-back sorts of small inputs
+// find them in cache, left there by the copy that made them; calls in a real program often don't.
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+enum class CacheState
+{
+    Batch, // every input of a repetition sorted back to back, timed as one (the default)
+    Warm,  // each sort timed alone, its input and scratch read just before
+    Cold,  // each sort timed alone, after streaming a buffer twice the last-level cache
+    Flush, // each sort timed alone, its input and scratch flushed from every cache level just before
+};
+
+// "batch", "warm", "cold", "flush"
+const char *cacheStateName(CacheState state);
+
+// Parses a comma-separated list of cache states ("all" selects every one). Prints the unknown name
+// and returns false on error.
+bool selectCacheStates(const std::string &list, std::vector<CacheState> &out);
+
+// Reads every cache line of [data, data + bytes).
+void warmRange(const void *data, size_t bytes);
+
+// Writes back and invalidates every cache line of [data, data + bytes) (clflush); elsewhere than
+// x86 it falls back to evictCaches().
+void flushRange(const void *data, size_t bytes);
+
+// Streams a buffer twice the size of the last-level cache (64 MB if that's unknown), which pushes
+// everything else out of the caches -- code and TLB entries included.
+void evictCaches();
@@ -0,0 +1,69 @@
+// disorder.cpp
+// Measures of presortedness.
+
+#include "disorder.h"
+
+#include <algorithm>
+#include <vector>
+
+// sorts 'a' by merging, counting the pairs it has to move past each other
+static uint64_t countInversions(std::vector<float> &a, std::vector<float> &tmp)
+{
+    uint64_t inversions = 0;
+    size_t n = a.size();
+    for (size_t width = 1; width < n; width *= 2)
+    {
+        for (size_t lo = 0; lo < n; lo += 2 * width)
+        {
+            size_t mid = std::min(lo + width, n), hi = std::min(lo + 2 * width, n);
+            size_t i = lo, j = mid, k = lo;
+            while (i < mid && j < hi)
+            {
+                if (a[j] < a[i])
+                {
+                    inversions += mid - i; // a[j] jumps every key left in the first half
+                    tmp[k++] = a[j++];
+                }
+                else
+                    tmp[k++] = a[i++];
+            }
+            while (i < mid)
+                tmp[k++] = a[i++];
+            while (j < hi)
+                tmp[k++] = a[j++];
+        }
+        a.swap(tmp);
+    }
+    return inversions;
+}
+
+DisorderMetrics measureDisorder(const float *data, uint32_t n)
+{
+    DisorderMetrics m;
+    if (n == 0)
+        return m;
+
+    m.runs = 1;
+    for (uint32_t i = 1; i < n; ++i)
+    {
+        if (data[i] < data[i - 1])
+            ++m.runs;
+    }
+
+    // Rem = n - longest non-decreasing subsequence (patience sorting: tails[k] is the smallest
+    // last key of any such subsequence of length k + 1)
+    std::vector<float> tails;
+    for (uint32_t i = 0; i < n; ++i)
+    {
+        auto it = std::upper_bound(tails.begin(), tails.end(), data[i]);
+        if (it == tails.end())
+            tails.push_back(data[i]);
+        else
+            *it = data[i];
+    }
+    m.rem = n - tails.size();
+
+    std::vector<float> a(data, data + n), tmp(n);
+    m.inversions = countInversions(a, tmp);
+    return m;
+}
@@ -0,0 +1,19 @@
+#pragma once
+
+// Measures of presortedness (Estivill-Castro & Wood, "A Survey of Adaptive Sorting Algorithms"),
+// reported next to throughput by --mode=presorted.
+
+#include <cstdint>
+
+struct DisorderMetrics
+{
+    uint64_t inversions = 0; // pairs i < j with a[i] > a[j]
+    uint64_t runs = 0;       // maximal non-decreasing runs (1 when sorted)
+    uint64_t rem = 0;        // fewest elements to remove to leave a sorted sequence
+
+    // inversions as a share of the most possible, n (n - 1) / 2
+    double inversionRatio(uint32_t n) const { return n > 1 ? 2.0 * double(inversions) / (double(n) * (n - 1)) : 0.0; }
+};
+
+// All three metrics of 'data' in O(n log n). Keys must be ordered by '<' (no NaNs).
+DisorderMetrics measureDisorder(const float *data, uint32_t n);
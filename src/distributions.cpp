@@ -0,0 +1,270 @@
+// distributions.cpp
+// Built-in input distributions.
+
+#include "distributions.h"
+
+// Standard Library Headers
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <functional>
+#include <iostream>
+#include <random>
+
+// Project Headers
+#include "parallel.h"
+
+// ------------------------------------------------------------------------------------------------
+// Generators
+
+static float fromBits(uint32_t bits)
+{
+    float f;
+    std::memcpy(&f, &bits, sizeof(f));
+    return f;
+}
+
+// uniform in [-16, 16]
+static float keyUniform(uint32_t, uint32_t, Philox &rng)
+{
+    return std::uniform_real_distribution<float>(-16.0f, 16.0f)(rng);
+}
+
+static void arrangeSorted(float *keys, uint32_t n, Philox &)
+{
+    std::sort(keys, keys + n);
+}
+
+static void arrangeReverse(float *keys, uint32_t n, Philox &)
+{
+    std::sort(keys, keys + n);
+    std::reverse(keys, keys + n);
+}
+
+void arrangeDisplaced(float *keys, uint32_t n, Philox &rng, double fraction, double range)
+{
+    std::sort(keys, keys + n);
+
+    uint32_t offsetRange = uint32_t(n * range);
+    uint32_t displace = uint32_t(n * fraction);
+    for (uint32_t j = 0; j < displace; ++j)
+    {
+        uint32_t i = rng() % n;
+        int32_t off = int32_t(rng() % (2 * offsetRange + 1)) - int32_t(offsetRange);
+        uint32_t k = uint32_t(std::clamp<int64_t>(int64_t(i) + off, 0, int64_t(n) - 1));
+        std::swap(keys[i], keys[k]);
+    }
+}
+
+void arrangeRuns(float *keys, uint32_t n, uint32_t runs)
+{
+    runs = std::clamp(runs, 1u, std::max(1u, n));
+    for (uint32_t r = 0; r < runs; ++r)
+        std::sort(keys + uint64_t(n) * r / runs, keys + uint64_t(n) * (r + 1) / runs);
+}
+
+void arrangeAscending(float *keys, uint32_t n, Philox &rng, double ascending)
+{
+    // 'share' shuffled positions leave 2 * share - share^2 of the pairs touched, half of them ordered
+    double order = std::max(ascending, 1.0 - ascending);
+    double share = 1.0 - std::sqrt(std::max(0.0, 2.0 * order - 1.0));
+    if (ascending >= 0.5)
+        std::sort(keys, keys + n);
+    else
+        std::sort(keys, keys + n, std::greater<float>());
+
+    std::vector<uint32_t> positions;
+    for (uint32_t i = 0; i < n; ++i)
+    {
+        if (std::uniform_real_distribution<double>(0.0, 1.0)(rng) < share)
+            positions.push_back(i);
+    }
+    for (size_t j = positions.size(); j > 1; --j)
+        std::swap(keys[positions[j - 1]], keys[positions[rng() % j]]);
+}
+
+// sorted, then 10% of the elements swapped with one up to 15% of N away
+static void arrangeMostlySorted(float *keys, uint32_t n, Philox &rng)
+{
+    arrangeDisplaced(keys, n, rng, 0.10, 0.15);
+}
+
+static float keyNormal(uint32_t, uint32_t, Philox &rng)
+{
+    return std::normal_distribution<float>(0.0f, 4.0f)(rng);
+}
+
+static float keyExponential(uint32_t, uint32_t, Philox &rng)
+{
+    return std::exponential_distribution<float>(1.0f)(rng);
+}
+
+// ranks 1..1000 with P(k) ~ 1/k
+static float keyZipf(uint32_t, uint32_t, Philox &rng)
+{
+    static const std::vector<double> cdf = [] {
+        std::vector<double> c(1000);
+        double sum = 0.0;
+        for (size_t k = 0; k < c.size(); ++k)
+            c[k] = sum += 1.0 / double(k + 1);
+        for (double &x : c)
+            x /= sum;
+        return c;
+    }();
+
+    double u = std::uniform_real_distribution<double>(0.0, 1.0)(rng);
+    size_t k = std::lower_bound(cdf.begin(), cdf.end(), u) - cdf.begin();
+    return float(std::min(k, cdf.size() - 1) + 1);
+}
+
+static float keyAllEqual(uint32_t, uint32_t, Philox &)
+{
+    return 1.0f;
+}
+
+// 16 distinct values
+static float keyFewUnique(uint32_t, uint32_t, Philox &rng)
+{
+    return float(int(rng() % 16) - 8) * 0.5f;
+}
+
+// 16 ascending runs
+static float keySawtooth(uint32_t i, uint32_t n, Philox &)
+{
+    return float(i % std::max(1u, n / 16));
+}
+
+// ascending to the middle, then descending
+static float keyOrganPipe(uint32_t i, uint32_t n, Philox &)
+{
+    return float(std::min(i, n - 1 - i));
+}
+
+// subnormals of both signs (built from bits: -ffast-math flushes arithmetic results to zero)
+static float keyDenormal(uint32_t, uint32_t, Philox &rng)
+{
+    uint32_t r = rng();
+    return fromBits((r & 0x80000000u) | (r & 0x007FFFFFu) | 1u);
+}
+
+// half +0 / -0, the rest small values of either sign
+static float keySignedZero(uint32_t, uint32_t, Philox &rng)
+{
+    uint32_t r = rng() % 4;
+    return r == 0 ? 0.0f : r == 1 ? -0.0f : std::uniform_real_distribution<float>(-1.0f, 1.0f)(rng);
+}
+
+// uniform, with 5% NaNs and 5% infinities of either sign
+static float keyNanInf(uint32_t i, uint32_t n, Philox &rng)
+{
+    uint32_t r = rng() % 40;
+    uint32_t sign = r & 1 ? 0x80000000u : 0u;
+    if (r < 2)
+        return fromBits(sign | 0x7FC00000u); // quiet NaN
+    if (r < 4)
+        return fromBits(sign | 0x7F800000u); // infinity
+    return keyUniform(i, n, rng);
+}
+
+// uniform in [1, 2): sign and exponent bits identical, so RadixSort11's top digit (bits 22-31) has
+// only 2 buckets in use, 0x2FE and 0x2FF of the flipped keys
+static float keySharedExponent(uint32_t, uint32_t, Philox &rng)
+{
+    return std::uniform_real_distribution<float>(1.0f, 2.0f)(rng);
+}
+
+// ------------------------------------------------------------------------------------------------
+// Registry
+
+const std::vector<Distribution> &distributionRegistry()
+{
+    static const std::vector<Distribution> distributions = {
+        {"random", "Random Input", false, keyUniform, nullptr},
+        {"mostly-sorted", "Mostly-Sorted Input", false, keyUniform, arrangeMostlySorted},
+        {"normal", "Normal Input", false, keyNormal, nullptr},
+        {"exponential", "Exponential Input", false, keyExponential, nullptr},
+        {"zipf", "Zipf Input", false, keyZipf, nullptr},
+        {"all-equal", "All-Equal Input", false, keyAllEqual, nullptr},
+        {"few-unique", "Few-Unique Input", false, keyFewUnique, nullptr},
+        {"sorted", "Sorted Input", false, keyUniform, arrangeSorted},
+        {"reverse", "Reverse-Sorted Input", false, keyUniform, arrangeReverse},
+        {"sawtooth", "Sawtooth Input", false, keySawtooth, nullptr},
+        {"organ-pipe", "Organ-Pipe Input", false, keyOrganPipe, nullptr},
+        {"denormals", "Denormal Input", false, keyDenormal, nullptr},
+        {"signed-zeros", "Signed-Zero Input", false, keySignedZero, nullptr},
+        {"nan-inf", "NaN/Inf Input", true, keyNanInf, nullptr},
+        {"shared-exponent", "Shared-Exponent Input", false, keySharedExponent, nullptr},
+    };
+    return distributions;
+}
+
+const Distribution *findDistribution(const std::string &name)
+{
+    for (const Distribution &d : distributionRegistry())
+    {
+        if (name == d.name)
+            return &d;
+    }
+    return nullptr;
+}
+
+bool selectDistributions(const std::string &list, std::vector<const Distribution *> &out)
+{
+    out.clear();
+    size_t pos = 0;
+    while (pos <= list.size())
+    {
+        size_t comma = list.find(',', pos);
+        std::string name = list.substr(pos, comma == std::string::npos ? std::string::npos : comma - pos);
+        pos = comma == std::string::npos ? list.size() + 1 : comma + 1;
+
+        if (name == "all")
+        {
+            for (const Distribution &d : distributionRegistry())
+                out.push_back(&d);
+            continue;
+        }
+
+        const Distribution *d = findDistribution(name);
+        if (!d)
+        {
+            std::cerr << "unknown distribution '" << name << "' (see --list-distributions)\n";
+            return false;
+        }
+        out.push_back(d);
+    }
+    return !out.empty();
+}
+
+bool isSortedByBits(const float *data, uint32_t n)
+{
+    auto key = [](float f) {
+        uint32_t u;
+        std::memcpy(&u, &f, sizeof(u));
+        return u & 0x80000000u ? ~u : u | 0x80000000u;
+    };
+    for (uint32_t i = 1; i < n; ++i)
+    {
+        if (key(data[i - 1]) > key(data[i]))
+            return false;
+    }
+    return true;
+}
+
+void generate(const Distribution &dist, float *out, uint32_t n, uint64_t seed, uint32_t stream, bool parallel)
+{
+    static constexpr size_t kGrain = 1u << 16;
+    parallelFor(n, parallel ? kGrain : SIZE_MAX, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i)
+        {
+            Philox rng(seed, stream, uint32_t(i));
+            out[i] = dist.key(uint32_t(i), n, rng);
+        }
+    });
+
+    if (dist.arrange)
+    {
+        Philox rng(seed, stream, UINT32_MAX); // past every key's index
+        dist.arrange(out, n, rng);
+    }
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+// Registry of the input distributions sort-bench can generate. Every engine runs on every selected
+// distribution (--distributions); NaN-bearing ones only on engines that order NaNs (SortEngine::
+// totalOrder), since comparison sorts are undefined on them.
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "philox.h"
+
+struct Distribution
+{
+    const char *name;  // CLI and --format=json|csv name
+    const char *label; // table heading
+    bool nans;         // contains NaNs: check the result by bit pattern, skip comparison sorts
+
+    // Key 'i' of 'n', drawn from 'rng' -- a generator of its own for that key, so keys can be made
+    // in any order and on any thread.
+    float (*key)(uint32_t i, uint32_t n, Philox &rng);
+
+    // Rearranges the finished keys (sorting, displacing), drawing from 'rng'; nullptr if there is
+    // nothing to do.
+    void (*arrange)(float *keys, uint32_t n, Philox &rng);
+};
+
+// All registered distributions, in a stable order.
+const std::vector<Distribution> &distributionRegistry();
+
+// Looks a distribution up by name; nullptr if unknown.
+const Distribution *findDistribution(const std::string &name);
+
+// Parses a comma-separated list of distribution names ("all" selects every one). Prints the unknown
+// name and returns false on failure.
+bool selectDistributions(const std::string &list, std::vector<const Distribution *> &out);
+
+// True if 'data' is in the order the radix sorts produce: by sign-flipped bit pattern, so -NaN <
+// -Inf < ... < -0 < +0 < ... < +Inf < +NaN.
+bool isSortedByBits(const float *data, uint32_t n);
+
+// Fills 'out' with input number 'stream' (n keys) of 'dist' under 'seed'. 'parallel' spreads the
+// keys over all hardware threads; the result is the same either way.
+void generate(const Distribution &dist, float *out, uint32_t n, uint64_t seed, uint32_t stream, bool parallel);
+
+// Building blocks for presortedness sweeps (--mode=presorted), on keys already generated:
+// sorts them, then swaps a 'fraction' of the positions each with a partner up to 'range' x n away
+// ("mostly-sorted" is fraction 0.10, range 0.15).
+void arrangeDisplaced(float *keys, uint32_t n, Philox &rng, double fraction, double range);
+
+// splits the keys into 'runs' equal contiguous parts and sorts each one
+void arrangeRuns(float *keys, uint32_t n, uint32_t runs);
+
+// Makes roughly an 'ascending' share (0..1) of neighbour pairs ordered, the measure the radix call
+// tracer records (--mode=replay): sorts the keys (descending below one half), then shuffles a share
+// of positions among themselves; each shuffled key leaves both of its pairs in order half the time.
+void arrangeAscending(float *keys, uint32_t n, Philox &rng, double ascending);
@@ -0,0 +1,198 @@
+// engines.cpp
+// Built-in sort engines: standard-library baselines and the radix variants.
+
+#include "engines.h"
+
+// Standard Library Headers
+#include <algorithm>
+#include <iostream>
+#include <thread>
+
+// Project Headers
+#include "radix_sort.h"
+#include "radix_tuning.h"
+
+// ------------------------------------------------------------------------------------------------
+// Engine entry points
+
+static uint32_t gParallelThreads = 0; // setParallelThreads; 0 = hardware concurrency
+
+void setParallelThreads(uint32_t threads)
+{
+    gParallelThreads = threads;
+#if SORT_BENCH_PSTL
+    setPstlThreads(threads);
+#endif
+}
+
+uint32_t parallelThreads()
+{
+    // read once: glibc answers hardware_concurrency from sysfs, which would dwarf a small timed sort
+    static const uint32_t hardware = std::max(1u, std::thread::hardware_concurrency());
+    return gParallelThreads ? gParallelThreads : hardware;
+}
+
+static float *sortStd(float *data, float *, uint32_t n)
+{
+    std::sort(data, data + n);
+    return data;
+}
+
+static float *sortStable(float *data, float *, uint32_t n)
+{
+    std::stable_sort(data, data + n);
+    return data;
+}
+
+static float *sortHeap(float *data, float *, uint32_t n)
+{
+    std::make_heap(data, data + n);
+    std::sort_heap(data, data + n);
+    return data;
+}
+
+static float *sortRadix11(float *data, float *scratch, uint32_t n)
+{
+    RadixSort11(data, scratch, n);
+    return scratch;
+}
+
+static float *sortRadix(float *data, float *scratch, uint32_t n)
+{
+    return RadixSort(data, data + n, scratch).data();
+}
+
+static float *sortRadixInPlace(float *data, float *scratch, uint32_t n)
+{
+    RadixOptions options;
+    options.resultInPlace = true;
+    return RadixSort(data, data + n, scratch, options).data();
+}
+
+static float *sortRadixStream(float *data, float *scratch, uint32_t n)
+{
+    RadixOptions options;
+    options.streamFinalPass = true;
+    return RadixSort(data, data + n, scratch, options).data();
+}
+
+static float *sortRadixParallel(float *data, float *scratch, uint32_t n)
+{
+    RadixOptions options;
+    options.threads = parallelThreads();
+    return RadixSort(data, data + n, scratch, options).data();
+}
+
+// ------------------------------------------------------------------------------------------------
+// Pass models
+
+static bool passesRadix11(uint32_t, PassModel &out)
+{
+    out.digitBits = 11;
+    out.scatters = 3;
+    return true;
+}
+
+// RadixSortKeys' plan for 'n' floats with default options (see RadixSortPlanned)
+static bool plannedPasses(uint32_t n, bool resultInPlace, PassModel &out)
+{
+    const RadixTuning &tuning = RadixGetTuning();
+    if (n < tuning.smallSortThreshold)
+        return false;
+
+    uint32_t bits = RadixLookupTuning(tuning, n).digitBits;
+    if (bits != 8 && bits != 16)
+        bits = 11;
+    if (resultInPlace && ((32 + bits - 1) / bits & 1))
+        bits = 8;
+    out.digitBits = bits;
+    out.scatters = (32 + bits - 1) / bits;
+    return true;
+}
+
+static bool passesRadix(uint32_t n, PassModel &out)
+{
+    return plannedPasses(n, false, out);
+}
+
+static bool passesRadixInPlace(uint32_t n, PassModel &out)
+{
+    return plannedPasses(n, true, out);
+}
+
+// ------------------------------------------------------------------------------------------------
+// Registry
+
+const std::vector<SortEngine> &engineRegistry()
+{
+    static const std::vector<SortEngine> engines = {
+        {"std::sort", kKeyAll, true, ScratchKind::None, 0.0, false, false, sortStd, nullptr},
+        {"std::stable_sort", kKeyAll, true, ScratchKind::Internal, 0.5, false, false, sortStable, nullptr},
+#if SORT_BENCH_PSTL
+        {"std::sort-par", kKeyAll, true, ScratchKind::Internal, 1.0, true, false, sortParUnseq, nullptr},
+#endif
+        {"heapsort", kKeyAll, true, ScratchKind::None, 0.0, false, false, sortHeap, nullptr},
+        {"radix11", kKeyFloat, false, ScratchKind::Caller, 1.0, false, true, sortRadix11, passesRadix11},
+        {"radix", kKeyAll, false, ScratchKind::Caller, 1.0, false, true, sortRadix, passesRadix},
+        {"radix-inplace", kKeyAll, true, ScratchKind::Caller, 1.0, false, true, sortRadixInPlace,
+         passesRadixInPlace},
+        {"radix-stream", kKeyAll, false, ScratchKind::Caller, 1.0, false, true, sortRadixStream, passesRadix},
+        {"radix-par", kKeyAll, false, ScratchKind::Caller, 1.0, true, true, sortRadixParallel, passesRadix},
+    };
+    return engines;
+}
+
+const SortEngine *findEngine(const std::string &name)
+{
+    for (const SortEngine &e : engineRegistry())
+    {
+        if (name == e.name)
+            return &e;
+    }
+    return nullptr;
+}
+
+bool selectEngines(const std::string &list, std::vector<const SortEngine *> &out)
+{
+    out.clear();
+    size_t pos = 0;
+    while (pos <= list.size())
+    {
+        size_t comma = list.find(',', pos);
+        std::string name = list.substr(pos, comma == std::string::npos ? std::string::npos : comma - pos);
+        pos = comma == std::string::npos ? list.size() + 1 : comma + 1;
+
+        if (name == "all")
+        {
+            for (const SortEngine &e : engineRegistry())
+                out.push_back(&e);
+            continue;
+        }
+
+        const SortEngine *e = findEngine(name);
+        if (!e)
+        {
+            std::cerr << "unknown engine '" << name << "' (see --list-engines)\n";
+            return false;
+        }
+        out.push_back(e);
+    }
+    return !out.empty();
+}
+
+std::string keyTypeNames(uint32_t keyTypes)
+{
+    static const char *kNames[] = {"f32", "f64", "i32", "u32", "i64", "u64"};
+
+    std::string names;
+    for (int i = 0; i < 6; ++i)
+    {
+        if (keyTypes & (1u << i))
+        {
+            if (!names.empty())
+                names += ",";
+            names += kNames[i];
+        }
+    }
+    return names;
+}
@@ -0,0 +1,81 @@
+#pragma once
+
+// Registry of the sort engines sort-bench can time. Each engine declares what it sorts and what it
+// needs; the bench only ever calls it through 'sort'.
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Key types an engine supports (bitmask).
+enum KeyTypeBits : uint32_t
+{
+    kKeyFloat = 1u << 0,
+    kKeyDouble = 1u << 1,
+    kKeyInt32 = 1u << 2,
+    kKeyUInt32 = 1u << 3,
+    kKeyInt64 = 1u << 4,
+    kKeyUInt64 = 1u << 5,
+    kKeyAll = 0x3Fu,
+};
+
+// Where an engine's extra memory comes from.
+enum class ScratchKind
+{
+    None,     // sorts within the input (plus stack)
+    Caller,   // needs a caller-supplied buffer of 'scratchPerElement' x N elements
+    Internal, // allocates its own
+};
+
+// Memory traffic of one radix sort, for the roofline report: a read pass that builds every
+// histogram, then 'scatters' passes that each read the keys and write them to 2^digitBits buckets.
+struct PassModel
+{
+    uint32_t digitBits = 0;
+    uint32_t scatters = 0;
+};
+
+struct SortEngine
+{
+    const char *name;
+    uint32_t keyTypes;        // KeyTypeBits
+    bool inPlace;             // the result always lands in the input buffer
+    ScratchKind scratch;      // extra memory, and who provides it
+    double scratchPerElement; // extra memory in elements per input element (upper bound)
+    bool parallel;            // runs on more than one thread
+    bool totalOrder;          // orders NaNs too (by bit pattern); comparison sorts are undefined on them
+
+    // Sorts 'n' floats at 'data', using 'scratch' (n elements; only touched when 'scratch' is
+    // ScratchKind::Caller). Returns the buffer holding the result.
+    float *(*sort)(float *data, float *scratch, uint32_t n);
+
+    // Fills in the passes a sort of 'n' floats makes; false (or nullptr) if it has no fixed pass
+    // structure -- comparison sorts, and radix engines that hand small inputs to insertion sort.
+    bool (*passes)(uint32_t n, PassModel &out);
+};
+
+// All registered engines, in a stable order.
+const std::vector<SortEngine> &engineRegistry();
+
+// Looks an engine up by name; nullptr if unknown.
+const SortEngine *findEngine(const std::string &name);
+
+// Parses a comma-separated list of engine names ("all" selects every engine). Prints the unknown
+// name and returns false on failure.
+bool selectEngines(const std::string &list, std::vector<const SortEngine *> &out);
+
+// Human-readable key type list, e.g. "f32,f64,i32".
+std::string keyTypeNames(uint32_t keyTypes);
+
+// Threads the parallel engines run on; 0 (the default) means every hardware thread. The radix
+// engine reads it per call; std::sort-par gets it as a tbb::global_control set here, outside any
+// timed call, where TBB is its backend.
+void setParallelThreads(uint32_t threads);
+uint32_t parallelThreads();
+
+// std::sort(std::execution::par_unseq, ...); built in engines_pstl.cpp when the toolchain's
+// parallel algorithms are available (SORT_BENCH_PSTL).
+float *sortParUnseq(float *data, float *scratch, uint32_t n);
+
+// Caps TBB's pool for sortParUnseq at 'threads' (0 = no cap); a no-op without TBB.
+void setPstlThreads(uint32_t threads);
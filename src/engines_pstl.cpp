@@ -0,0 +1,33 @@
+// engines_pstl.cpp
+// The parallel-STL baseline. Kept in its own translation unit: libstdc++'s parallel algorithms
+// need exceptions, which the rest of the build turns off.
+
+#include <algorithm>
+#include <execution>
+
+#if SORT_BENCH_TBB
+#include <memory>
+
+#include <tbb/global_control.h>
+#endif
+
+#include "engines.h"
+
+void setPstlThreads(uint32_t threads)
+{
+#if SORT_BENCH_TBB
+    // libstdc++ runs par_unseq on TBB's pool: cap it until the next call, 0 lifts the cap
+    static std::unique_ptr<tbb::global_control> limit;
+    limit.reset();
+    if (threads)
+        limit.reset(new tbb::global_control(tbb::global_control::max_allowed_parallelism, threads));
+#else
+    (void)threads;
+#endif
+}
+
+float *sortParUnseq(float *data, float *, uint32_t n)
+{
+    std::sort(std::execution::par_unseq, data, data + n);
+    return data;
+}
@@ -1,158 +1,2401 @@
 // sort_bench.cpp
 // Benchmarks std::sort vs RadixSort11 over a range of input sizes,
 // for both random and mostly-sorted inputs.
+//
+// Usage: sort-bench [--mode=throughput|inplace|stream|prefetch|autotune|presorted|roofline|latency|replay|
+//                          contention|firsttouch]
+//                   [--min-log2=N] [--max-log2=N] [--pf-src=D,..] [--pf-dst=D,..]
+//                   [--pf-src-hint=H,..] [--pf-dst-hint=H,..] [--tuning=FILE]
+//                   [--tuning-out=FILE] [--engines=NAME,..|all] [--list-engines]
+//                   [--reps=R] [--warmup=W] [--pin=CPU] [--counters] [--memory]
+//                   [--format=table|json|csv] [--baseline=FILE.json] [--threshold=PCT]
+//                   [--distributions=NAME,..|all] [--list-distributions]
+//                   [--displace=PCT,..] [--displace-range=PCT,..] [--runs=K,..]
+//                   [--cache=batch|warm|cold|flush,..|all] [--threads=T,..|max]
+//                   [--placement=cores|compact|os] [--calls=C] [--trace=FILE] [--trace-out=FILE]
+//                   [--timeline=FILE.json] [--telemetry[=NAME]] [--tenants=K,..] [--hog=T]
+//                   [--mlock]
 
 // Standard Library Headers
 #include <algorithm>
 #include <chrono>
+#include <cmath>
 #include <cstdint>
+#include <cstdlib>
+#include <cstring>
 #include <iomanip>
 #include <iostream>
+#include <memory>
 #include <random>
+#include <sstream>
+#include <string>
+#include <thread>
 #include <vector>
 
 // Project Headers
-#include "radix.h"
+#include "bandwidth.h"
+#include "cache_state.h"
+#include "disorder.h"
+#include "distributions.h"
+#include "engines.h"
+#include "memory_usage.h"
+#include "parallel.h"
+#include "perf_counters.h"
+#include "radix_scratch.h"
+#include "radix_sort.h"
+#include "radix_telemetry.h"
+#include "radix_timeline.h"
+#include "radix_trace.h"
+#include "radix_tuning.h"
+#include "report.h"
+#include "sysinfo.h"
+#include "timing.h"
 
 // ------------------------------------------------------------------------------------------------
 // Config parameters
 
+using Clock = std::chrono::steady_clock;
+
 static constexpr uint32_t kMaxTotal = 16 * 1024 * 1024; // cap N * trials to 16M
 static constexpr uint32_t kMaxTrials = 128;
+static constexpr uint32_t kColdTrials = 16; // --cache=cold streams twice the LLC before every sort
 static constexpr bool kCheckCorrect = true; // Verify sorting order
+static constexpr uint32_t kHotSetBytes = 256 * 1024; // follow-up working set for --mode=stream
+static constexpr uint64_t kInputSeed = 1234;          // every generated input derives from this
+
+// Command line options
+struct BenchOptions
+{
+    std::string mode = "throughput"; // throughput | inplace | stream | prefetch | autotune | presorted |
+                                     // roofline | latency | replay | contention | firsttouch
+    int minLog2 = 1;                 // smallest size is 2^minLog2
+    int maxLog2 = 24;                // largest size is 2^maxLog2
+
+    // --mode=prefetch sweeps every combination of these; --mode=autotune picks from them
+    std::vector<uint32_t> pfSrc = {0, 64, 128, 256};
+    std::vector<uint32_t> pfDst = {0, 8, 16};
+    std::vector<RadixPrefetchHint> pfSrcHint = {RadixPrefetchHint::T0};
+    std::vector<RadixPrefetchHint> pfDstHint = {RadixPrefetchHint::T0};
+
+    std::string tuning;                        // profile to load before running (default $RADIX_TUNING)
+    std::string tuningOut = "radix_tuning.txt"; // where --mode=autotune writes its profile
+
+    std::vector<const SortEngine *> engines; // --mode=throughput columns (--engines)
+    bool listEngines = false;
+
+    std::vector<const Distribution *> distributions; // inputs, one table each (--distributions)
+    bool listDistributions = false;
+
+    int reps = 5;   // timed repetitions per engine and size (--mode=throughput)
+    int warmup = 1; // untimed repetitions before them
+    int pin = -1;   // logical CPU to pin to, -1 = don't
+
+    bool counters = false; // hardware counters per engine and size (--mode=throughput)
+    bool memory = false;   // heap, stack and resident set use per engine and size (--mode=throughput)
+
+    std::string format = "table"; // table | json | csv (--mode=throughput)
+
+    std::vector<CacheState> cache = {CacheState::Batch}; // input cache states, one table each (--cache)
+
+    // --mode=presorted series: displaced share and distance (fractions of N), sorted run counts
+    std::vector<double> displace = {0.0, 0.001, 0.01, 0.05, 0.10, 0.25, 0.50, 1.0};
+    std::vector<double> displaceRange = {0.0001, 0.001, 0.01, 0.15, 1.0};
+    std::vector<uint32_t> runs = {1, 2, 8, 64, 512, 4096, 32768};
+
+    uint32_t calls = 0; // --mode=latency: timed calls per engine and size, 0 = by size; --mode=replay:
+                        // the first calls of the trace to play back, 0 = all
+
+    std::string trace;    // --mode=replay: radix call trace to play back
+    std::string traceOut; // record the radix calls of any mode into this file (radix_trace.h)
+    std::string timeline; // record the parallel radix phases into this Chrome trace (radix_timeline.h)
+
+    bool telemetry = false;    // publish the radix calls' counters in shared memory (radix_telemetry.h)
+    std::string telemetryName; // shared-memory name, empty = "/radix-telemetry.<pid>"
+
+    // thread-scaling sweep of the parallel engines (--threads; empty = no sweep) and where its
+    // threads run: one per physical core first, SMT siblings together, or wherever the OS puts them
+    std::vector<uint32_t> threads;
+    std::string placement = "cores"; // cores | compact | os
+
+    // --mode=contention: concurrent sorting threads per run, and threads generating memory traffic
+    std::vector<uint32_t> tenants = {1, 2, 4, 8, 16};
+    uint32_t hog = 0;
+
+    bool mlock = false; // --mode=firsttouch: lock the prefaulted scratch buffers too
+
+    std::string baseline;   // --format=json file to compare against
+    double threshold = 3.0; // smallest throughput drop (%) --baseline reports as a regression
+};
+
+static const char *kHintNames[] = {"t0", "t1", "t2", "nta"};
 
 // ------------------------------------------------------------------------------------------------
 // Utility functions
 
-// generate 'trials' independent vectors of length 'N'
-// if 'mostlySorted' is true, start with a sorted list and then displace some (default 10%) of the elements
-void generateInputs(uint32_t trials, uint32_t N, bool mostlySorted, std::vector<std::vector<float>> &out)
+// parse a comma-separated list of unsigned integers
+bool parseUintList(const char *value, std::vector<uint32_t> &out)
+{
+    out.clear();
+    for (const char *p = value; *p;)
+    {
+        char *end;
+        unsigned long v = std::strtoul(p, &end, 10);
+        if (end == p || (*end && *end != ','))
+            return false;
+        out.push_back(uint32_t(v));
+        p = *end ? end + 1 : end;
+    }
+    return !out.empty();
+}
+
+// parse a comma-separated list of percentages into fractions
+bool parsePercentList(const char *value, std::vector<double> &out)
 {
-    std::mt19937 rng(1234);
-    std::uniform_real_distribution<float> dist(-16.0f, 16.0f);
-    out.assign(trials, std::vector<float>(N));
+    out.clear();
+    for (const char *p = value; *p;)
+    {
+        char *end;
+        double v = std::strtod(p, &end);
+        if (end == p || (*end && *end != ',') || v < 0.0)
+            return false;
+        out.push_back(v / 100.0);
+        p = *end ? end + 1 : end;
+    }
+    return !out.empty();
+}
 
-    if (mostlySorted)
+// parse a comma-separated list of thread counts; "max" is every CPU the process may run on
+bool parseThreadList(const char *value, std::vector<uint32_t> &out)
+{
+    out.clear();
+    for (const char *p = value; *p;)
     {
-        uint32_t offsetRange = uint32_t(N * 0.15f); // +/- 15% of N
-        uint32_t displace = uint32_t(N * 0.10f);    // displace 10% of the elements
-        for (uint32_t t = 0; t < trials; ++t)
+        size_t len = std::strcspn(p, ",");
+        char *end = nullptr;
+        unsigned long v = len == 3 && std::strncmp(p, "max", 3) == 0 ? std::max<size_t>(1, allowedCpus().size())
+                                                                     : std::strtoul(p, &end, 10);
+        if ((end && end != p + len) || v == 0)
+            return false;
+        out.push_back(uint32_t(v));
+        p += len;
+        if (*p)
+            ++p;
+    }
+    return !out.empty();
+}
+
+// parse a comma-separated list of prefetch hints (t0, t1, t2, nta)
+bool parseHintList(const char *value, std::vector<RadixPrefetchHint> &out)
+{
+    out.clear();
+    for (const char *p = value; *p;)
+    {
+        size_t len = std::strcspn(p, ",");
+        bool found = false;
+        for (int h = 0; h < 4; ++h)
         {
-            auto &v = out[t];
-            for (uint32_t i = 0; i < N; ++i)
+            if (std::strlen(kHintNames[h]) == len && std::strncmp(p, kHintNames[h], len) == 0)
             {
-                v[i] = dist(rng);
+                out.push_back(RadixPrefetchHint(h));
+                found = true;
             }
+        }
+        if (!found)
+            return false;
+        p += len;
+        if (*p)
+            ++p;
+    }
+    return !out.empty();
+}
 
-            // start with a sorted list
-            std::sort(v.begin(), v.end());
+// parse '--name=value' flags into 'opts'; returns false (after printing usage) on anything unknown
+bool parseArgs(int argc, char **argv, BenchOptions &opts)
+{
+    for (int i = 1; i < argc; ++i)
+    {
+        const char *arg = argv[i];
+        const char *eq = std::strchr(arg, '=');
+        std::string name(arg, eq ? size_t(eq - arg) : std::strlen(arg));
+        const char *value = eq ? eq + 1 : "";
 
-            // displace
-            for (uint32_t j = 0; j < displace; ++j)
-            {
-                uint32_t i = rng() % N;
-                int32_t off = int32_t(rng() % (2 * offsetRange + 1)) - int32_t(offsetRange);
-                uint32_t k = uint32_t(std::clamp<int32_t>(i + off, 0, int32_t(N - 1)));
-                std::swap(v[i], v[k]);
-            }
+        if (name == "--mode" && (std::strcmp(value, "throughput") == 0 || std::strcmp(value, "inplace") == 0 ||
+                                 std::strcmp(value, "stream") == 0 || std::strcmp(value, "prefetch") == 0 ||
+                                 std::strcmp(value, "autotune") == 0 || std::strcmp(value, "presorted") == 0 ||
+                                 std::strcmp(value, "roofline") == 0 || std::strcmp(value, "latency") == 0 ||
+                                 std::strcmp(value, "replay") == 0 || std::strcmp(value, "contention") == 0 ||
+                                 std::strcmp(value, "firsttouch") == 0))
+            opts.mode = value;
+        else if (name == "--min-log2" && *value)
+            opts.minLog2 = std::clamp(std::atoi(value), 1, 31);
+        else if (name == "--max-log2" && *value)
+            opts.maxLog2 = std::clamp(std::atoi(value), 1, 31);
+        else if (name == "--pf-src" && parseUintList(value, opts.pfSrc))
+            ;
+        else if (name == "--pf-dst" && parseUintList(value, opts.pfDst))
+            ;
+        else if (name == "--pf-src-hint" && parseHintList(value, opts.pfSrcHint))
+            ;
+        else if (name == "--pf-dst-hint" && parseHintList(value, opts.pfDstHint))
+            ;
+        else if (name == "--tuning" && *value)
+            opts.tuning = value;
+        else if (name == "--tuning-out" && *value)
+            opts.tuningOut = value;
+        else if (name == "--engines" && *value)
+        {
+            if (!selectEngines(value, opts.engines))
+                return false;
+        }
+        else if (name == "--list-engines" && !eq)
+            opts.listEngines = true;
+        else if (name == "--distributions" && *value)
+        {
+            if (!selectDistributions(value, opts.distributions))
+                return false;
+        }
+        else if (name == "--list-distributions" && !eq)
+            opts.listDistributions = true;
+        else if (name == "--reps" && *value)
+            opts.reps = std::max(1, std::atoi(value));
+        else if (name == "--warmup" && *value)
+            opts.warmup = std::max(0, std::atoi(value));
+        else if (name == "--pin" && *value)
+            opts.pin = std::atoi(value);
+        else if (name == "--counters" && !eq)
+            opts.counters = true;
+        else if (name == "--memory" && !eq)
+            opts.memory = true;
+        else if (name == "--format" && (std::strcmp(value, "table") == 0 || std::strcmp(value, "json") == 0 ||
+                                        std::strcmp(value, "csv") == 0))
+            opts.format = value;
+        else if (name == "--displace" && parsePercentList(value, opts.displace))
+            ;
+        else if (name == "--displace-range" && parsePercentList(value, opts.displaceRange))
+            ;
+        else if (name == "--runs" && parseUintList(value, opts.runs))
+            ;
+        else if (name == "--cache" && *value)
+        {
+            if (!selectCacheStates(value, opts.cache))
+                return false;
+        }
+        else if (name == "--calls" && *value)
+            opts.calls = uint32_t(std::strtoul(value, nullptr, 10));
+        else if (name == "--threads" && parseThreadList(value, opts.threads))
+            ;
+        else if (name == "--placement" && (std::strcmp(value, "cores") == 0 || std::strcmp(value, "compact") == 0 ||
+                                           std::strcmp(value, "os") == 0))
+            opts.placement = value;
+        else if (name == "--trace" && *value)
+            opts.trace = value;
+        else if (name == "--trace-out" && *value)
+            opts.traceOut = value;
+        else if (name == "--timeline" && *value)
+            opts.timeline = value;
+        else if (name == "--telemetry")
+        {
+            opts.telemetry = true;
+            opts.telemetryName = value;
+        }
+        else if (name == "--tenants" && *value && parseUintList(value, opts.tenants) &&
+                 std::find(opts.tenants.begin(), opts.tenants.end(), 0u) == opts.tenants.end())
+            ;
+        else if (name == "--hog" && *value)
+            opts.hog = uint32_t(std::strtoul(value, nullptr, 10));
+        else if (name == "--mlock")
+            opts.mlock = true;
+        else if (name == "--baseline" && *value)
+            opts.baseline = value;
+        else if (name == "--threshold" && *value)
+            opts.threshold = std::max(0.0, std::atof(value));
+        else
+        {
+            std::cerr << "unknown option '" << arg << "'\n"
+                      << "usage: sort-bench [--mode=throughput|inplace|stream|prefetch|autotune|presorted|roofline|"
+                         "latency|replay|contention|firsttouch]\n"
+                      << "                  [--min-log2=N] [--max-log2=N] [--pf-src=D,..] [--pf-dst=D,..]\n"
+                      << "                  [--pf-src-hint=H,..] [--pf-dst-hint=H,..] [--tuning=FILE]\n"
+                      << "                  [--tuning-out=FILE] [--engines=NAME,..|all] [--list-engines]\n"
+                      << "                  [--reps=R] [--warmup=W] [--pin=CPU] [--counters] [--memory]\n"
+                      << "                  [--format=table|json|csv] [--baseline=FILE.json] [--threshold=PCT]\n"
+                      << "                  [--distributions=NAME,..|all] [--list-distributions]\n"
+                      << "                  [--displace=PCT,..] [--displace-range=PCT,..] [--runs=K,..]\n"
+                      << "                  [--cache=batch|warm|cold|flush,..|all] [--threads=T,..|max]\n"
+                      << "                  [--placement=cores|compact|os] [--calls=C] [--trace=FILE]\n"
+                      << "                  [--trace-out=FILE] [--timeline=FILE.json] [--telemetry[=NAME]]\n"
+                      << "                  [--tenants=K,..] [--hog=T] [--mlock]\n"
+                      << "                  (D: distance in elements, 0 = off; H: t0|t1|t2|nta)\n";
+            return false;
+        }
+    }
+
+    if (opts.engines.empty())
+        selectEngines("std::sort,radix", opts.engines);
+    if (opts.distributions.empty())
+        selectDistributions("random,mostly-sorted", opts.distributions);
+    return true;
+}
+
+// print the engine registry
+void listEngines()
+{
+    std::cout << std::left << std::setw(18) << "Engine" << std::setw(26) << "Key types" << std::setw(10)
+              << "In place" << std::setw(22) << "Scratch" << std::setw(10) << "Parallel" << "NaNs\n";
+    for (const SortEngine &e : engineRegistry())
+    {
+        static const char *kScratchNames[] = {"none", "caller", "internal"};
+        std::ostringstream scratch;
+        scratch << kScratchNames[int(e.scratch)];
+        if (e.scratch != ScratchKind::None)
+            scratch << " (" << e.scratchPerElement << " x N)";
+
+        std::cout << std::setw(18) << e.name << std::setw(26) << keyTypeNames(e.keyTypes) << std::setw(10)
+                  << (e.inPlace ? "yes" : "no") << std::setw(22) << scratch.str() << std::setw(10)
+                  << (e.parallel ? "yes" : "no") << (e.totalOrder ? "ordered" : "undefined") << "\n";
+    }
+    std::cout << std::right;
+}
+
+// print the distribution registry
+void listDistributions()
+{
+    for (const Distribution &d : distributionRegistry())
+        std::cout << std::left << std::setw(18) << d.name << d.label << (d.nans ? " (NaN-bearing)" : "") << "\n";
+    std::cout << std::right;
+}
+
+double secondsSince(Clock::time_point t0)
+{
+    return std::chrono::duration<double>(Clock::now() - t0).count();
+}
+
+// generate 'trials' independent vectors of length 'N' from 'dist': seeded and counter-based, so the
+// same every call however the work is split -- across trials, or across each input's keys when
+// there are fewer trials than threads
+void generateInputs(uint32_t trials, uint32_t N, const Distribution &dist, std::vector<std::vector<float>> &out)
+{
+    out.resize(trials);
+    for (auto &v : out)
+        v.resize(N);
+
+    bool perKey = trials < std::thread::hardware_concurrency();
+    parallelFor(trials, perKey ? SIZE_MAX : 1, [&](size_t begin, size_t end) {
+        for (size_t t = begin; t < end; ++t)
+            generate(dist, out[t].data(), N, kInputSeed, uint32_t(t), perKey);
+    });
+}
+
+// copy generated inputs into the buffers an engine sorts
+void copyInputs(const std::vector<std::vector<float>> &from, std::vector<std::vector<float>> &to)
+{
+    to.resize(from.size());
+    for (size_t t = 0; t < from.size(); ++t)
+    {
+        to[t].resize(from[t].size());
+        parallelCopy(to[t].data(), from[t].data(), from[t].size() * sizeof(float));
+    }
+}
+
+// 'data' is in order: by bit pattern for NaN-bearing distributions, where '<' can't tell
+bool isSorted(const Distribution &dist, const float *data, uint32_t N)
+{
+    return dist.nans ? isSortedByBits(data, N) : std::is_sorted(data, data + N);
+}
+
+// ------------------------------------------------------------------------------------------------
+// Benchmark modes
+
+// --telemetry: what counting costs RadixSort at N=64, where a call is short enough for it to weigh
+// most. Timing sorts with telemetry off and on can't resolve a 1% difference on a noisy machine, so
+// the two are measured apart: the fastest of 51 batches of 1024 sorts of fresh inputs, and the
+// fastest of 51 batches of 1024 passes through the engines' counting steps (radix.cpp), done on a
+// slot of our own so the published counters stay true. Returns the second as a share of the first.
+double telemetryOverhead()
+{
+    static constexpr uint32_t kN = 64, kCalls = 1024, kBatches = 51;
+
+    std::vector<std::vector<float>> source, inputs;
+    generateInputs(kCalls, kN, *findDistribution("random"), source);
+    std::vector<float> scratch(kN);
+    RadixTelemetrySlot slot = {};
+    double sort = 1e30, count = 1e30;
+    for (uint32_t b = 0; b < kBatches; ++b)
+    {
+        copyInputs(source, inputs);
+        auto t0 = Clock::now();
+        for (std::vector<float> &keys : inputs)
+            RadixSort(keys, scratch);
+        sort = std::min(sort, secondsSince(t0));
+
+        t0 = Clock::now();
+        for (uint32_t c = 0; c < kCalls; ++c)
+        {
+            if (!RadixTelemetryEnabled() || !RadixTelemetryThreadSlot())
+                continue;
+            uint64_t weight = RadixTelemetryWeight(&slot, kN);
+            uint64_t ticks = weight ? RadixTelemetryTicks() : 0;
+            if (weight)
+                ticks = (RadixTelemetryTicks() - ticks) * weight;
+            RadixTelemetryCount(&slot, kN, sizeof(float), kRadixPath11, ticks);
+        }
+        count = std::min(count, secondsSince(t0));
+    }
+    return count / sort;
+}
+
+// --trace-out, --timeline: stop recording radix calls and parallel phases and write them out
+void finishTrace(const BenchOptions &opts)
+{
+    if (!opts.timeline.empty())
+    {
+        RadixTimelineStop();
+        uint64_t dropped = 0;
+        size_t events = RadixTimelineSnapshot(&dropped).size();
+        if (RadixTimelineWriteChrome(opts.timeline.c_str()))
+            std::cerr << "wrote " << events << " parallel sort phases (" << dropped << " dropped) to "
+                      << opts.timeline << "\n";
+        else
+            std::cerr << "could not write timeline " << opts.timeline << "\n";
+    }
+
+    if (opts.traceOut.empty())
+        return;
+    RadixTraceStop();
+    uint64_t dropped = 0;
+    size_t calls = RadixTraceSnapshot(&dropped).size();
+    if (RadixTraceDump(opts.traceOut.c_str()))
+        std::cerr << "wrote " << calls << " radix calls (" << dropped << " dropped) to " << opts.traceOut << "\n";
+    else
+        std::cerr << "could not write call trace " << opts.traceOut << "\n";
+}
+
+// print 'counts' per element after a throughput row, n/a where a counter is missing
+void printCounters(const PerfCounts &counts, double elements)
+{
+    std::cout << std::setprecision(3);
+    if (counts.valid[kPerfCycles] && counts.valid[kPerfInstructions] && counts.value[kPerfCycles] > 0)
+        std::cout << std::setw(8) << counts.value[kPerfInstructions] / counts.value[kPerfCycles];
+    else
+        std::cout << std::setw(8) << "n/a";
+    for (int c = 0; c < kPerfEventCount; ++c)
+    {
+        if (counts.valid[c])
+            std::cout << std::setw(19) << counts.value[c] / elements;
+        else
+            std::cout << std::setw(19) << "n/a";
+    }
+    std::cout << std::setprecision(2);
+}
+
+// print the memory columns of a throughput row: caller scratch for 'N' elements, then 'usage' over
+// 'sorts' sorts, in KB and allocations per sort
+void printMemory(const SortEngine &engine, const MemoryUsage &usage, uint32_t N, double sorts)
+{
+    double scratch = engine.scratch == ScratchKind::Caller ? std::ceil(N * engine.scratchPerElement) : 0;
+    std::cout << std::setprecision(1) << std::setw(12) << scratch * sizeof(float) / 1024;
+    std::cout << std::setw(12) << usage.heapPeak / 1024.0 << std::setw(12) << usage.stackPeak / 1024.0
+              << std::setw(12) << usage.rssPeak / 1024.0 << std::setw(12) << usage.allocations / sorts;
+    std::cout << std::setprecision(2);
+}
+
+// Sorts a fresh copy of 'source' (inputs generated from 'dist') with 'engine' and returns the time
+// taken for all of them. With 'counters', the same region is also counted and added to 'counts';
+// with 'meter', its memory use is added to 'usage'. Any 'cache' state but Batch times each sort
+// alone, after putting its input and scratch in that state; only the sorts are timed, counted and
+// metered.
+double timeEngine(const SortEngine &engine, const Distribution &dist, const std::vector<std::vector<float>> &source,
+                  std::vector<std::vector<float>> &inputs, CacheState cache = CacheState::Batch,
+                  PerfCounters *counters = nullptr, PerfCounts *counts = nullptr, MemoryMeter *meter = nullptr,
+                  MemoryUsage *usage = nullptr)
+{
+    uint32_t trials = uint32_t(source.size());
+    uint32_t N = uint32_t(source[0].size());
+
+    // copy the inputs, and make scratch if the engine wants it
+    copyInputs(source, inputs);
+    std::vector<float> scratch(engine.scratch == ScratchKind::Caller ? size_t(std::ceil(N * engine.scratchPerElement))
+                                                                      : 0);
+
+    float *result = nullptr;
+    double dur = 0;
+    if (cache == CacheState::Batch)
+    {
+        if (meter)
+            meter->start();
+        if (counters)
+            counters->start();
+        auto t0 = Clock::now();
+        for (uint32_t t = 0; t < trials; ++t)
+        {
+            result = engine.sort(inputs[t].data(), scratch.data(), N);
         }
+        dur = secondsSince(t0);
+        if (counters)
+            *counts += counters->stop();
+        if (meter)
+            *usage += meter->stop();
     }
     else
     {
         for (uint32_t t = 0; t < trials; ++t)
         {
-            auto &v = out[t];
-            for (float &x : v)
+            size_t bytes = size_t(N) * sizeof(float), scratchBytes = scratch.size() * sizeof(float);
+            if (cache == CacheState::Warm)
+            {
+                warmRange(inputs[t].data(), bytes);
+                warmRange(scratch.data(), scratchBytes);
+            }
+            else if (cache == CacheState::Flush)
             {
-                x = dist(rng);
+                flushRange(inputs[t].data(), bytes);
+                flushRange(scratch.data(), scratchBytes);
             }
+            else
+                evictCaches();
+
+            if (meter)
+                meter->start();
+            if (counters)
+                counters->start();
+            auto t0 = Clock::now();
+            result = engine.sort(inputs[t].data(), scratch.data(), N);
+            dur += secondsSince(t0);
+            if (counters)
+                *counts += counters->stop();
+            if (meter)
+                *usage += meter->stop();
         }
     }
+
+    if (kCheckCorrect)
+    {
+        if (!isSorted(dist, result, N))
+            std::cerr << engine.name << " failed on " << dist.name << " at N=" << N << "\n";
+    }
+    return dur;
 }
 
-// ------------------------------------------------------------------------------------------------
-// Main function
+// sorts per repetition at size N: cap trials to keep the time reasonable, and further when every
+// sort pays for a full cache eviction
+uint32_t trialsFor(uint32_t N, CacheState cache = CacheState::Batch)
+{
+    uint32_t trials = std::min(kMaxTrials, std::max(1u, kMaxTotal / N));
+    return cache == CacheState::Cold ? std::min(trials, kColdTrials) : trials;
+}
+
+// record scenario: the distribution, tagged with the cache state unless it is the default
+std::string scenarioName(const Distribution &dist, CacheState cache)
+{
+    if (cache == CacheState::Batch)
+        return dist.name;
+    return std::string(dist.name) + "/" + cacheStateName(cache);
+}
 
-int main()
+// 'warmup' untimed and 'reps' timed repetitions of every engine on copies of 'source' (inputs drawn
+// from 'dist'), shuffling the engine order every repetition; appends one record per timed
+// repetition to 'records'. Engines that can't order NaNs are left out on NaN-bearing distributions.
+// Timed repetitions put each input in the 'cache' state first; warmups just run back to back.
+void timeRepetitions(const std::vector<const SortEngine *> &engines, const Distribution &dist, CacheState cache,
+                     const std::vector<std::vector<float>> &source, int warmup, int reps, std::mt19937 &orderRng,
+                     PerfCounters *counters, MemoryMeter *meter, std::vector<std::vector<float>> &inputs,
+                     std::vector<BenchRecord> &records)
 {
-    // Run two passes/scenarios: random input and mostly-sorted input
-    struct Scenario
+    uint32_t trials = uint32_t(source.size());
+    uint32_t N = uint32_t(source[0].size());
+    std::vector<size_t> order(engines.size());
+    for (size_t i = 0; i < order.size(); ++i)
+        order[i] = i;
+
+    for (int r = -warmup; r < reps; ++r)
     {
-        const char *label;
-        bool mostlySorted;
-    };
-    const Scenario scenarios[2] = {{"Random Input", false}, {"Mostly-Sorted Input", true}};
+        std::shuffle(order.begin(), order.end(), orderRng);
+        for (size_t i : order)
+        {
+            if (dist.nans && !engines[i]->totalOrder)
+                continue;
+            if (r < 0)
+            {
+                timeEngine(*engines[i], dist, source, inputs);
+                continue;
+            }
+
+            BenchRecord rec;
+            rec.engine = engines[i]->name;
+            rec.scenario = scenarioName(dist, cache);
+            rec.elements = N;
+            rec.trials = trials;
+            rec.rep = r;
+            rec.seconds =
+                timeEngine(*engines[i], dist, source, inputs, cache, counters, &rec.counters, meter, &rec.memory);
+            records.push_back(rec);
+        }
+    }
+}
+
+// Builds with ENABLE_RADIX_STATS: where RadixSort11's time goes at each size, as nanoseconds per
+// element and share of the sort for each phase (one run of 'trials' sorts).
+void printPhases(const BenchOptions &opts, const Distribution &dist, std::vector<std::vector<float>> &inputs)
+{
+    static const char *kPhaseNames[5] = {"Histogram", "Prefix sum", "Scatter 0", "Scatter 1", "Scatter 2"};
+
+    std::cout << "\n=== " << dist.label << ", RadixSort11 phases (ns/element, % of sort) ===\n";
+    std::cout << std::setw(12) << "Elements";
+    for (const char *name : kPhaseNames)
+        std::cout << std::setw(12) << name << std::setw(8) << "%";
+    std::cout << "\n";
+
+    for (int e = opts.minLog2; e <= opts.maxLog2; ++e)
+    {
+        uint32_t N = 1u << e;
+        uint32_t trials = trialsFor(N);
+        std::vector<float> scratch(N);
+
+        generateInputs(trials, N, dist, inputs);
+        RadixPassStats stats;
+        for (uint32_t t = 0; t < trials; ++t)
+        {
+            RadixSort11(inputs[t].data(), scratch.data(), N, &stats);
+        }
 
-    std::vector<std::vector<float>> inputsStd, inputsRadix;
-    inputsStd.reserve(kMaxTrials);
-    inputsRadix.reserve(kMaxTrials);
+        double phases[5] = {double(stats.histogramNs), double(stats.prefixSumNs), double(stats.scatterNs[0]),
+                            double(stats.scatterNs[1]), double(stats.scatterNs[2])};
+        double total = 0;
+        for (double ns : phases)
+            total += ns;
+
+        std::cout << std::setw(12) << N;
+        for (double ns : phases)
+            std::cout << std::setw(12) << ns / (double(N) * trials) << std::setw(8) << 100.0 * ns / total;
+        std::cout << "\n";
+    }
+}
+
+// Every selected engine (--engines), one table per scenario. Each size runs --warmup untimed and
+// --reps timed repetitions, shuffling the engine order every repetition so slow drift (thermal,
+// frequency, other load) spreads over all engines. Rows report the median, the MAD as a share of
+// it, the best repetition and a confidence interval for the median; speedups compare medians
+// against the first engine. With --counters, each row also gets the hardware counters of its timed
+// repetitions per element sorted (IPC is instructions per cycle); counters the machine won't give
+// us print as n/a. With --memory, each row also gets what the engine needs beyond its input: the
+// scratch the bench hands it, and over the timed repetitions the most heap live at once, the deepest
+// stack, the resident set growth (KB) and the heap allocations per sort (memory_usage.h). The
+// probes run outside the timed region but touch memory of their own, so take speeds from runs
+// without it. Builds with ENABLE_RADIX_STATS follow each table with RadixSort11's phases.
+// A scenario is a distribution and a cache state (--cache); the default, batch, leaves small inputs
+// in cache the way back-to-back sorts find them. --format=json|csv replaces the tables with one
+// record per timed repetition (report.h).
+void runThroughput(const BenchOptions &opts)
+{
+    std::vector<std::vector<float>> inputs;
+    inputs.reserve(kMaxTrials);
+
+    const std::vector<const SortEngine *> &engines = opts.engines;
+    std::mt19937 orderRng(4321);
+    const bool table = opts.format == "table";
+    std::vector<BenchRecord> records;
+
+    std::unique_ptr<PerfCounters> counters;
+    if (opts.counters)
+    {
+        counters = std::make_unique<PerfCounters>();
+        if (!counters->status().empty())
+            std::cerr << "warning: " << counters->status() << "\n";
+        if (!counters->available())
+            counters.reset();
+    }
+    std::unique_ptr<MemoryMeter> meter;
+    if (opts.memory)
+    {
+        meter = std::make_unique<MemoryMeter>();
+        if (!meter->status().empty())
+            std::cerr << "warning: " << meter->status() << "\n";
+    }
+
+    std::vector<std::pair<const Distribution *, CacheState>> scenarios;
+    for (const Distribution *dist : opts.distributions)
+    {
+        for (CacheState cache : opts.cache)
+            scenarios.emplace_back(dist, cache);
+    }
 
     // For each scenario, print a table:
-    for (auto &s : scenarios)
+    for (const auto &scenario : scenarios)
     {
-        // Print header
-        std::cout << "\n=== " << s.label << " (million elements/sec) ===\n";
+        const Distribution *dist = scenario.first;
+        CacheState cache = scenario.second;
 
-        // single‐row header, widths tuned to fit content
-        std::cout << std::fixed << std::setprecision(2) << std::setw(12) << "Elements" << std::setw(16) << "std::sort"
-                  << std::setw(16) << "Radix" << std::setw(12) << "Speedup"
-                  << "\n";
+        // Print header
+        if (table)
+        {
+            std::cout << "\n=== " << dist->label;
+            if (cache != CacheState::Batch)
+                std::cout << ", " << cacheStateName(cache) << " cache";
+            std::cout << " (million elements/sec, " << opts.reps << " repetitions) ===\n";
+            std::cout << std::fixed << std::setprecision(2) << std::setw(12) << "Elements" << "  " << std::left
+                      << std::setw(18) << "Engine" << std::right << std::setw(12) << "Median" << std::setw(10)
+                      << "MAD %" << std::setw(12) << "Best" << std::setw(12) << "CI low" << std::setw(12)
+                      << "CI high" << std::setw(8) << "CI %" << std::setw(12) << "Speedup";
+            if (opts.counters)
+            {
+                std::cout << std::setw(8) << "IPC";
+                for (int c = 0; c < kPerfEventCount; ++c)
+                    std::cout << std::setw(19) << PerfCounters::name(c);
+            }
+            if (opts.memory)
+                std::cout << std::setw(12) << "Scratch KB" << std::setw(12) << "Heap KB" << std::setw(12)
+                          << "Stack KB" << std::setw(12) << "RSS KB" << std::setw(12) << "Allocs";
+            std::cout << "\n";
+        }
 
-        // sizes 2^1 .. 2^24
-        for (int e = 1; e <= 24; ++e)
+        // sizes 2^minLog2 .. 2^maxLog2
+        for (int e = opts.minLog2; e <= opts.maxLog2; ++e)
         {
             uint32_t N = 1u << e;
-            // cap trials to keep the time reasonable
-            uint32_t trials = std::min(kMaxTrials, std::max(1u, kMaxTotal / N));
+            uint32_t trials = trialsFor(N, cache);
 
-            // generate inputs for this scenario
-            generateInputs(trials, N, s.mostlySorted, inputsStd);
-            generateInputs(trials, N, s.mostlySorted, inputsRadix);
+            std::vector<std::vector<float>> source;
+            generateInputs(trials, N, *dist, source);
+            size_t first = records.size();
+            timeRepetitions(engines, *dist, cache, source, opts.warmup, opts.reps, orderRng, counters.get(),
+                            meter.get(), inputs, records);
+            if (!table)
+                continue;
 
-            // output buffer for radix
-            std::vector<float> radixOut(N);
+            std::vector<std::vector<double>> samples(engines.size());
+            std::vector<PerfCounts> counts(engines.size());
+            std::vector<MemoryUsage> memory(engines.size());
+            for (size_t k = first; k < records.size(); ++k)
+            {
+                for (size_t i = 0; i < engines.size(); ++i)
+                {
+                    if (records[k].engine == engines[i]->name)
+                    {
+                        samples[i].push_back(records[k].seconds);
+                        counts[i] += records[k].counters;
+                        memory[i] += records[k].memory;
+                    }
+                }
+            }
 
-            // --- std::sort
-            auto t0 = std::chrono::high_resolution_clock::now();
-            for (uint32_t t = 0; t < trials; ++t)
+            // print rows: throughput is the reciprocal of time, so the interval's ends swap
+            double work = double(N) * trials / 1e6;
+            double baseline = summarize(samples[0]).median;
+            for (size_t i = 0; i < engines.size(); ++i)
             {
-                std::sort(inputsStd[t].begin(), inputsStd[t].end());
+                SampleStats st = summarize(samples[i]);
+                if (i == 0)
+                    std::cout << std::setw(12) << N;
+                else
+                    std::cout << std::setw(12) << "";
+                std::cout << "  " << std::left << std::setw(18) << engines[i]->name << std::right;
+                if (samples[i].empty())
+                {
+                    std::cout << std::setw(12) << "n/a" << "  (undefined on NaNs)\n";
+                    continue;
+                }
+                std::cout << std::setw(12) << work / st.median << std::setw(10) << 100.0 * st.mad / st.median
+                          << std::setw(12) << work / st.min << std::setw(12) << work / st.ciHigh << std::setw(12)
+                          << work / st.ciLow << std::setw(8) << std::setprecision(0) << 100.0 * st.ciLevel
+                          << std::setprecision(2);
+                if (baseline > 0)
+                    std::cout << std::setw(11) << baseline / st.median << "x";
+                else
+                    std::cout << std::setw(12) << "n/a";
+                if (opts.counters)
+                    printCounters(counts[i], double(N) * trials * opts.reps);
+                if (opts.memory)
+                    printMemory(*engines[i], memory[i], N, double(trials) * opts.reps);
+                std::cout << "\n";
             }
-            auto t1 = std::chrono::high_resolution_clock::now();
+        }
+
+        if (table && RADIX_STATS && cache == CacheState::Batch)
+            printPhases(opts, *dist, inputs);
+    }
 
-            double durStd = std::chrono::duration<double>(t1 - t0).count();
-            double epsStd = double(N) * trials / durStd / 1e6;
+    if (table)
+        return;
 
-            if (kCheckCorrect)
+    // run metadata: the build and machine, then how this run was set up
+    BenchMetadata meta = collectMetadata();
+    std::string engineNames;
+    for (const SortEngine *engine : engines)
+        engineNames += (engineNames.empty() ? "" : ",") + std::string(engine->name);
+    meta.emplace_back("mode", opts.mode);
+    meta.emplace_back("engines", engineNames);
+    std::string distributionNames;
+    for (const Distribution *dist : opts.distributions)
+        distributionNames += (distributionNames.empty() ? "" : ",") + std::string(dist->name);
+    meta.emplace_back("distributions", distributionNames);
+    std::string cacheNames;
+    for (CacheState cache : opts.cache)
+        cacheNames += (cacheNames.empty() ? "" : ",") + std::string(cacheStateName(cache));
+    meta.emplace_back("cache", cacheNames);
+    meta.emplace_back("reps", std::to_string(opts.reps));
+    meta.emplace_back("warmup", std::to_string(opts.warmup));
+    meta.emplace_back("pin", std::to_string(opts.pin));
+    meta.emplace_back("counters", counters ? "on" : "off");
+    meta.emplace_back("memory", opts.memory ? "on" : "off");
+
+    if (opts.format == "json")
+        writeJson(std::cout, meta, records);
+    else
+        writeCsv(std::cout, meta, records);
+}
+
+// --threads: every parallel engine selected with --engines (all of them if none is) at each thread
+// count and size. Rows report the median throughput, the speedup over the same engine at the first
+// thread count in the list, and the parallel efficiency (speedup per thread added). Each table ends
+// with the size from which on each thread count stays faster than the first. With --placement=cores
+// or compact, a run with T threads is confined to the first T CPUs of placementOrder (sysinfo.h);
+// the OS still places the threads within that set.
+void runThreadScaling(const BenchOptions &opts)
+{
+    std::vector<const SortEngine *> engines;
+    for (const SortEngine *engine : opts.engines)
+    {
+        if (engine->parallel)
+            engines.push_back(engine);
+    }
+    if (engines.empty())
+    {
+        for (const SortEngine &engine : engineRegistry())
+        {
+            if (engine.parallel)
+                engines.push_back(&engine);
+        }
+    }
+
+    const std::vector<int> allowed = allowedCpus();
+    const bool place = opts.placement != "os" && !allowed.empty();
+    const std::vector<int> order = place ? placementOrder(allowed, opts.placement == "cores") : allowed;
+    std::cout << "\nplacement: " << opts.placement;
+    if (place)
+    {
+        std::cout << " (cpus";
+        for (int cpu : order)
+            std::cout << " " << cpu;
+        std::cout << ")";
+    }
+    std::cout << "\n";
+    for (uint32_t t : opts.threads)
+    {
+        if (t > allowed.size() && !allowed.empty())
+        {
+            std::cerr << "warning: " << t << " threads on " << allowed.size() << " cpus oversubscribes them\n";
+            break;
+        }
+    }
+
+    std::vector<std::vector<float>> inputs;
+    inputs.reserve(kMaxTrials);
+    std::mt19937 orderRng(4321);
+    const uint32_t t0 = opts.threads[0];
+
+    for (const Distribution *dist : opts.distributions)
+    {
+        std::cout << "\n=== " << dist->label << ", thread scaling (million elements/sec, " << opts.reps
+                  << " repetitions) ===\n";
+        std::cout << std::fixed << std::setprecision(2) << std::setw(12) << "Elements" << "  " << std::left
+                  << std::setw(18) << "Engine" << std::right << std::setw(8) << "Threads" << std::setw(12) << "Median"
+                  << std::setw(10) << "MAD %" << std::setw(10) << "Speedup" << std::setw(14) << "Efficiency %"
+                  << "\n";
+
+        // speedup[engine][thread count][size]
+        std::vector<std::vector<std::vector<double>>> speedup(
+            engines.size(), std::vector<std::vector<double>>(opts.threads.size()));
+
+        for (int e = opts.minLog2; e <= opts.maxLog2; ++e)
+        {
+            uint32_t N = 1u << e;
+            uint32_t trials = trialsFor(N);
+            std::vector<std::vector<float>> source;
+            generateInputs(trials, N, *dist, source);
+
+            // records[thread count]
+            std::vector<std::vector<BenchRecord>> records(opts.threads.size());
+            for (size_t k = 0; k < opts.threads.size(); ++k)
             {
-                if (!std::is_sorted(inputsStd.back().begin(), inputsStd.back().end()))
-                    std::cerr << "std::sort failed at N=" << N << "\n";
+                uint32_t t = opts.threads[k];
+                setParallelThreads(t);
+                if (place)
+                    pinToCpus(std::vector<int>(order.begin(), order.begin() + std::min<size_t>(t, order.size())));
+                timeRepetitions(engines, *dist, CacheState::Batch, source, opts.warmup, opts.reps, orderRng, nullptr,
+                                nullptr, inputs, records[k]);
+                if (place)
+                    pinToCpus(allowed);
             }
 
-            // --- RadixSort11
-            t0 = std::chrono::high_resolution_clock::now();
-            for (uint32_t t = 0; t < trials; ++t)
+            double work = double(N) * trials / 1e6;
+            for (size_t i = 0; i < engines.size(); ++i)
             {
-                RadixSort11(inputsRadix[t].data(), radixOut.data(), N);
+                double base = 0;
+                for (size_t k = 0; k < opts.threads.size(); ++k)
+                {
+                    std::vector<double> samples;
+                    for (const BenchRecord &r : records[k])
+                    {
+                        if (r.engine == engines[i]->name)
+                            samples.push_back(r.seconds);
+                    }
+
+                    std::cout << std::setw(12) << (i == 0 && k == 0 ? std::to_string(N) : std::string()) << "  "
+                              << std::left << std::setw(18) << (k == 0 ? engines[i]->name : "") << std::right
+                              << std::setw(8) << opts.threads[k];
+                    if (samples.empty())
+                    {
+                        std::cout << std::setw(12) << "n/a" << "  (undefined on NaNs)\n";
+                        continue;
+                    }
+                    SampleStats st = summarize(samples);
+                    if (k == 0)
+                        base = st.median;
+                    double s = base / st.median;
+                    speedup[i][k].push_back(s);
+                    std::cout << std::setw(12) << work / st.median << std::setw(10) << 100.0 * st.mad / st.median
+                              << std::setw(9) << s << "x" << std::setw(14) << 100.0 * s * t0 / opts.threads[k]
+                              << "\n";
+                }
+            }
+        }
+
+        // smallest size from which on the speedup stays above 1
+        std::cout << "\nPays off (faster than " << t0 << (t0 == 1 ? " thread" : " threads") << " from then on):\n";
+        for (size_t i = 0; i < engines.size(); ++i)
+        {
+            for (size_t k = 1; k < opts.threads.size(); ++k)
+            {
+                const std::vector<double> &s = speedup[i][k];
+                size_t from = s.size();
+                while (from > 0 && s[from - 1] > 1.0)
+                    --from;
+                std::cout << "  " << std::left << std::setw(18) << engines[i]->name << std::right << std::setw(4)
+                          << opts.threads[k] << (opts.threads[k] == 1 ? " thread:  " : " threads: ");
+                if (s.empty() || from == s.size())
+                    std::cout << "not up to " << (1u << opts.maxLog2) << " elements\n";
+                else
+                    std::cout << "from " << (1u << (opts.minLog2 + from)) << " elements\n";
             }
-            t1 = std::chrono::high_resolution_clock::now();
+        }
+    }
+    setParallelThreads(0);
+}
 
-            double durRadix = std::chrono::duration<double>(t1 - t0).count();
-            double epsRadix = double(N) * trials / durRadix / 1e6;
+// --baseline: reruns the baseline file's matrix (engines, distributions, sizes, repetitions) and compares
+// throughput per engine, scenario and size. A row regresses when its median dropped by more than
+// the threshold -- --threshold, or twice the larger relative MAD of the two runs if that is noisier
+// -- and a one-sided Mann-Whitney test over the repetitions puts the drop below 5% chance. Returns
+// the number of regressions.
+int runBaseline(const BenchOptions &opts)
+{
+    BenchMetadata meta;
+    std::vector<BenchRecord> base;
+    std::string error;
+    if (!readJson(opts.baseline, meta, base, error))
+    {
+        std::cerr << error << "\n";
+        return -1;
+    }
 
-            if (kCheckCorrect)
+    // the baseline's matrix
+    std::string engineList;
+    int reps = opts.reps, warmup = opts.warmup;
+    for (const auto &kv : meta)
+    {
+        if (kv.first == "engines")
+            engineList = kv.second;
+        else if (kv.first == "reps")
+            reps = std::max(1, std::atoi(kv.second.c_str()));
+        else if (kv.first == "warmup")
+            warmup = std::max(0, std::atoi(kv.second.c_str()));
+    }
+    std::vector<const SortEngine *> engines;
+    if (engineList.empty() || !selectEngines(engineList.c_str(), engines))
+    {
+        std::cerr << opts.baseline << ": no usable engine list in the metadata\n";
+        return -1;
+    }
+    // scenarios: a distribution, then "/state" for any cache state but batch
+    std::vector<std::pair<const Distribution *, CacheState>> scenarios;
+    for (const BenchRecord &r : base)
+    {
+        size_t slash = r.scenario.find('/');
+        const Distribution *d = findDistribution(r.scenario.substr(0, slash));
+        std::vector<CacheState> cache = {CacheState::Batch};
+        if (!d || (slash != std::string::npos && !selectCacheStates(r.scenario.substr(slash + 1), cache)))
+        {
+            std::cerr << opts.baseline << ": unknown scenario '" << r.scenario << "'\n";
+            return -1;
+        }
+        std::pair<const Distribution *, CacheState> scenario(d, cache[0]);
+        if (std::find(scenarios.begin(), scenarios.end(), scenario) == scenarios.end())
+            scenarios.push_back(scenario);
+    }
+
+    std::vector<std::vector<float>> inputs;
+    inputs.reserve(kMaxTrials);
+    std::mt19937 orderRng(4321);
+
+    // throughput of every repetition, per (scenario, size, engine)
+    auto throughputs = [](const std::vector<BenchRecord> &records, const BenchRecord &key) {
+        std::vector<double> out;
+        for (const BenchRecord &r : records)
+        {
+            if (r.engine == key.engine && r.scenario == key.scenario && r.elements == key.elements)
+                out.push_back(double(r.elements) * r.trials / r.seconds / 1e6);
+        }
+        return out;
+    };
+
+    std::cout << "\n=== Baseline " << opts.baseline << " (million elements/sec, " << reps
+              << " repetitions) ===\n";
+    std::cout << std::fixed << std::setprecision(2) << std::left << std::setw(16) << "Scenario" << std::right
+              << std::setw(12) << "Elements" << "  " << std::left << std::setw(18) << "Engine" << std::right
+              << std::setw(12) << "Baseline" << std::setw(12) << "Current" << std::setw(10) << "Change %"
+              << std::setw(10) << "Thresh %" << std::setw(10) << "p" << "  Verdict\n";
+
+    int regressions = 0;
+    for (const auto &scenario : scenarios)
+    {
+        const Distribution *dist = scenario.first;
+        CacheState cache = scenario.second;
+        std::string name = scenarioName(*dist, cache);
+
+        // sizes the baseline has for this scenario
+        std::vector<uint32_t> sizes;
+        for (const BenchRecord &r : base)
+        {
+            if (r.scenario == name && std::find(sizes.begin(), sizes.end(), r.elements) == sizes.end())
+                sizes.push_back(r.elements);
+        }
+        std::sort(sizes.begin(), sizes.end());
+
+        for (uint32_t N : sizes)
+        {
+            std::vector<std::vector<float>> source;
+            generateInputs(trialsFor(N, cache), N, *dist, source);
+            std::vector<BenchRecord> current;
+            timeRepetitions(engines, *dist, cache, source, warmup, reps, orderRng, nullptr, nullptr, inputs, current);
+
+            for (const SortEngine *engine : engines)
             {
-                if (!std::is_sorted(radixOut.begin(), radixOut.end()))
-                    std::cerr << "RadixSort11 failed at N=" << N << "\n";
+                BenchRecord key;
+                key.engine = engine->name;
+                key.scenario = name;
+                key.elements = N;
+                std::vector<double> before = throughputs(base, key), after = throughputs(current, key);
+                if (before.empty())
+                    continue;
+
+                SampleStats b = summarize(before), a = summarize(after);
+                double change = a.median / b.median - 1.0;
+                double noise = std::max(b.mad / b.median, a.mad / a.median);
+                double threshold = std::max(opts.threshold / 100.0, 2.0 * noise);
+
+                const char *verdict = "ok";
+                double p = -1.0; // only tested beyond the threshold
+                if (change < -threshold)
+                {
+                    p = mannWhitneyGreater(before, after);
+                    if (p < 0.05)
+                    {
+                        verdict = "REGRESSION";
+                        ++regressions;
+                    }
+                }
+                else if (change > threshold)
+                {
+                    p = mannWhitneyGreater(after, before);
+                    if (p < 0.05)
+                        verdict = "faster";
+                }
+
+                std::cout << std::left << std::setw(16) << name << std::right << std::setw(12) << N << "  "
+                          << std::left << std::setw(18) << engine->name << std::right << std::setw(12) << b.median
+                          << std::setw(12) << a.median << std::setw(10) << 100.0 * change << std::setw(10)
+                          << 100.0 * threshold << std::setprecision(4);
+                if (p < 0)
+                    std::cout << std::setw(10) << "-";
+                else
+                    std::cout << std::setw(10) << p;
+                std::cout << std::setprecision(2) << "  " << verdict << "\n";
             }
+        }
+    }
 
-            double speedup = epsRadix / epsStd;
+    std::cout << "\n" << regressions << (regressions == 1 ? " regression\n" : " regressions\n");
+    return regressions;
+}
+
+// Builds with ENABLE_RADIX_STATS: the bandwidth each of RadixSort11's memory passes reaches at each
+// size, and its share of the matching probe -- the histogram pass against the read probe, each
+// scatter against the 2048-bucket scatter probe.
+void printPassRoofline(const BenchOptions &opts, const Distribution &dist,
+                       const std::vector<BandwidthProbe> &probes, std::vector<std::vector<float>> &inputs)
+{
+    static const char *kPassNames[4] = {"Histogram", "Scatter 0", "Scatter 1", "Scatter 2"};
+
+    std::cout << "\n=== " << dist.label << ", RadixSort11 passes (GB/s, % of probe) ===\n";
+    std::cout << std::setw(12) << "Elements";
+    for (const char *name : kPassNames)
+        std::cout << std::setw(12) << name << std::setw(8) << "%";
+    std::cout << "\n";
 
-            // print row
-            std::cout << std::setw(12) << N << std::setw(16) << epsStd << std::setw(16) << epsRadix << std::setw(11)
-                      << speedup << "x\n";
+    for (int e = opts.minLog2; e <= opts.maxLog2; ++e)
+    {
+        uint32_t N = 1u << e;
+        uint32_t trials = trialsFor(N);
+        std::vector<float> scratch(N);
+
+        generateInputs(trials, N, dist, inputs);
+        RadixPassStats stats;
+        for (uint32_t t = 0; t < trials; ++t)
+        {
+            RadixSort11(inputs[t].data(), scratch.data(), N, &stats);
         }
+
+        // bytes per ns is GB/s
+        const BandwidthProbe &probe = probes[e - opts.minLog2];
+        double keys = double(N) * trials;
+        double achieved[4] = {4 * keys / stats.histogramNs, 8 * keys / stats.scatterNs[0],
+                              8 * keys / stats.scatterNs[1], 8 * keys / stats.scatterNs[2]};
+        double roof[4] = {probe.read, scatterBandwidth(probe, 11), scatterBandwidth(probe, 11),
+                          scatterBandwidth(probe, 11)};
+
+        std::cout << std::setw(12) << N;
+        for (int p = 0; p < 4; ++p)
+            std::cout << std::setw(12) << achieved[p] << std::setw(8) << 100.0 * achieved[p] / roof[p];
+        std::cout << "\n";
     }
+}
 
-    return 0;
+// How close each engine gets to what the memory system allows. For every size, the bandwidth one
+// thread reaches reading, writing, copying and scattering a working set that size (bandwidth.h);
+// then, per distribution, each engine's median throughput, the bytes per key its passes move (4
+// for the histogram read, 8 per scatter), that traffic in GB/s, and the roofline: the throughput
+// it would reach if every pass ran at its probe's bandwidth. Engines without a fixed pass
+// structure print n/a; parallel engines are held to the one-thread probes, so they can pass 100%.
+// Builds with ENABLE_RADIX_STATS follow each table with RadixSort11's passes.
+void runRoofline(const BenchOptions &opts)
+{
+    std::cout << "\n=== Bandwidth probes (GB/s, one thread) ===\n";
+    std::cout << std::fixed << std::setprecision(2) << std::setw(12) << "Elements" << std::setw(10) << "Read"
+              << std::setw(10) << "Write" << std::setw(10) << "Copy";
+    for (uint32_t fanout : kScatterFanouts)
+        std::cout << std::setw(14) << "Scatter " + std::to_string(fanout);
+    std::cout << "\n";
+
+    std::vector<BandwidthProbe> probes;
+    for (int e = opts.minLog2; e <= opts.maxLog2; ++e)
+    {
+        probes.push_back(measureBandwidth(1u << e));
+        const BandwidthProbe &probe = probes.back();
+        std::cout << std::setw(12) << (1u << e) << std::setw(10) << probe.read << std::setw(10) << probe.write
+                  << std::setw(10) << probe.copy;
+        for (double gbs : probe.scatter)
+            std::cout << std::setw(14) << gbs;
+        std::cout << "\n";
+    }
+
+    const std::vector<const SortEngine *> &engines = opts.engines;
+    std::vector<std::vector<float>> inputs;
+    inputs.reserve(kMaxTrials);
+    std::mt19937 orderRng(4321);
+
+    for (const Distribution *dist : opts.distributions)
+    {
+        std::cout << "\n=== " << dist->label << ", roofline (million elements/sec, " << opts.reps
+                  << " repetitions) ===\n";
+        std::cout << std::setw(12) << "Elements" << "  " << std::left << std::setw(18) << "Engine" << std::right
+                  << std::setw(12) << "Median" << std::setw(8) << "Passes" << std::setw(10) << "Bytes/key"
+                  << std::setw(10) << "GB/s" << std::setw(12) << "Roofline" << std::setw(8) << "%" << "\n";
+
+        for (int e = opts.minLog2; e <= opts.maxLog2; ++e)
+        {
+            uint32_t N = 1u << e;
+            uint32_t trials = trialsFor(N);
+            const BandwidthProbe &probe = probes[e - opts.minLog2];
+
+            std::vector<std::vector<float>> source;
+            generateInputs(trials, N, *dist, source);
+            std::vector<BenchRecord> records;
+            timeRepetitions(engines, *dist, CacheState::Batch, source, opts.warmup, opts.reps, orderRng, nullptr,
+                            nullptr, inputs, records);
+
+            for (size_t i = 0; i < engines.size(); ++i)
+            {
+                const SortEngine *engine = engines[i];
+                std::vector<double> samples;
+                for (const BenchRecord &r : records)
+                {
+                    if (r.engine == engine->name)
+                        samples.push_back(r.seconds);
+                }
+
+                if (i == 0)
+                    std::cout << std::setw(12) << N;
+                else
+                    std::cout << std::setw(12) << "";
+                std::cout << "  " << std::left << std::setw(18) << engine->name << std::right;
+                if (samples.empty())
+                {
+                    std::cout << std::setw(12) << "n/a" << "  (undefined on NaNs)\n";
+                    continue;
+                }
+                double melems = double(N) * trials / summarize(samples).median / 1e6;
+                std::cout << std::setw(12) << melems;
+
+                PassModel model;
+                if (!engine->passes || !engine->passes(N, model))
+                {
+                    std::cout << std::setw(8) << "n/a" << std::setw(10) << "n/a" << std::setw(10) << "n/a"
+                              << std::setw(12) << "n/a" << std::setw(8) << "n/a" << "\n";
+                    continue;
+                }
+
+                // ns per key at each probe's bandwidth (GB/s is bytes per ns)
+                double bytes = 4.0 + 8.0 * model.scatters;
+                double roofNs = 4.0 / probe.read + 8.0 * model.scatters / scatterBandwidth(probe, model.digitBits);
+                double roofline = 1e3 / roofNs;
+                std::cout << std::setw(8) << std::to_string(model.scatters) + "x" + std::to_string(model.digitBits)
+                          << std::setw(10) << bytes << std::setw(10) << melems * bytes / 1e3 << std::setw(12)
+                          << roofline << std::setw(8) << 100.0 * melems / roofline << "\n";
+            }
+        }
+
+        if (RADIX_STATS)
+            printPassRoofline(opts, *dist, probes, inputs);
+    }
+}
+
+// Per-call latency: every selected engine sorts one input at a time, each call timed on its own
+// (CallTimer: rdtscp or steady_clock, less the timer's overhead) into a LatencyHistogram. Per scenario
+// and size, the first call -- into fresh, untouched scratch (RadixAllocScratch), so its page faults
+// and any lazy setup included -- is reported on its own; then --calls more (by default from 10000 at small sizes down to 32, so each
+// engine sorts ~64M keys) give the percentiles. Inputs rotate through the size's generated set and
+// are copied in untimed before every call, then put in the --cache state.
+void runLatency(const BenchOptions &opts)
+{
+    static constexpr uint64_t kLatencyKeys = 64ull * 1024 * 1024;
+
+    CallTimer timer;
+    std::cout << "\ntimer: " << timer.source() << ", " << std::fixed << std::setprecision(3) << timer.ticksPerNs()
+              << " ticks/ns, " << std::setprecision(1) << timer.overheadNs() << " ns overhead (subtracted)\n";
+
+    const std::vector<const SortEngine *> &engines = opts.engines;
+    for (const Distribution *dist : opts.distributions)
+    {
+        for (CacheState cache : opts.cache)
+        {
+            std::cout << "\n=== " << dist->label;
+            if (cache != CacheState::Batch)
+                std::cout << ", " << cacheStateName(cache) << " cache";
+            std::cout << " (microseconds per call) ===\n";
+            std::cout << std::fixed << std::setprecision(2) << std::setw(12) << "Elements" << "  " << std::left
+                      << std::setw(18) << "Engine" << std::right << std::setw(8) << "Calls" << std::setw(12) << "First"
+                      << std::setw(12) << "Min" << std::setw(12) << "p50" << std::setw(12) << "p90" << std::setw(12)
+                      << "p99" << std::setw(12) << "p99.9" << std::setw(12) << "Max" << "\n";
+
+            for (int e = opts.minLog2; e <= opts.maxLog2; ++e)
+            {
+                uint32_t N = 1u << e;
+                uint32_t calls = opts.calls ? opts.calls : uint32_t(std::clamp<uint64_t>(kLatencyKeys / N, 32, 10000));
+                std::vector<std::vector<float>> source;
+                generateInputs(trialsFor(N, cache), N, *dist, source);
+
+                for (size_t i = 0; i < engines.size(); ++i)
+                {
+                    const SortEngine &engine = *engines[i];
+                    std::cout << std::setw(12) << (i == 0 ? std::to_string(N) : std::string()) << "  " << std::left
+                              << std::setw(18) << engine.name << std::right;
+                    if (dist->nans && !engine.totalOrder)
+                    {
+                        std::cout << std::setw(8) << "n/a" << "  (undefined on NaNs)\n";
+                        continue;
+                    }
+
+                    // fresh scratch for every engine and size, mapped but not touched: the first call
+                    // pays for its pages (the input buffer is written by the copy before every call)
+                    std::vector<float> work(N);
+                    size_t scratchBytes = engine.scratch == ScratchKind::Caller
+                                              ? size_t(std::ceil(N * engine.scratchPerElement)) * sizeof(float)
+                                              : 0;
+                    RadixScratch scratch = RadixAllocScratch(scratchBytes);
+                    if (scratchBytes && !scratch.data)
+                    {
+                        std::cout << std::setw(8) << "n/a" << "  (no memory for scratch)\n";
+                        continue;
+                    }
+                    float *scratchData = static_cast<float *>(scratch.data);
+                    LatencyHistogram histogram;
+                    double first = 0;
+                    float *result = nullptr;
+
+                    for (uint32_t c = 0; c <= calls; ++c)
+                    {
+                        const std::vector<float> &input = source[c % source.size()];
+                        std::memcpy(work.data(), input.data(), N * sizeof(float));
+                        if (cache == CacheState::Warm)
+                        {
+                            warmRange(work.data(), N * sizeof(float));
+                            warmRange(scratchData, scratchBytes);
+                        }
+                        else if (cache == CacheState::Flush)
+                        {
+                            flushRange(work.data(), N * sizeof(float));
+                            flushRange(scratchData, scratchBytes);
+                        }
+                        else if (cache == CacheState::Cold)
+                            evictCaches();
+
+                        uint64_t t0 = timer.start();
+                        result = engine.sort(work.data(), scratchData, N);
+                        uint64_t t1 = timer.stop();
+                        if (c == 0)
+                            first = timer.ns(t0, t1);
+                        else
+                            histogram.record(timer.ns(t0, t1));
+                    }
+
+                    if (kCheckCorrect && !isSorted(*dist, result, N))
+                        std::cerr << engine.name << " failed on " << dist->name << " at N=" << N << "\n";
+                    RadixFreeScratch(scratch);
+
+                    std::cout << std::setw(8) << calls << std::setw(12) << first / 1e3 << std::setw(12)
+                              << histogram.min() / 1e3;
+                    for (double p : {50.0, 90.0, 99.0, 99.9})
+                        std::cout << std::setw(12) << histogram.percentile(p) / 1e3;
+                    std::cout << std::setw(12) << histogram.max() / 1e3 << "\n";
+                }
+            }
+        }
+    }
+}
+
+// --mode=replay: plays a radix call trace (--trace; written by --trace-out or RadixTraceDump) back
+// against every selected engine. Each call gets fresh random keys of its size, arranged to the
+// presortedness the tracer sampled (arrangeAscending), and every engine sorts a copy of them, timed
+// alone with CallTimer. Rows group the calls by size class (up to 2^k elements): how many, their
+// share of the traced elements, how many neighbour pairs were in order, the time the traced calls
+// took and each engine's replay time; the last row totals them. The bench's engines sort floats, so
+// traced double and integer calls replay as floats of the same size.
+int runReplay(const BenchOptions &opts)
+{
+    static const char *kKeyNames[] = {"f32", "f64", "i32", "u32", "i64", "u64"};
+
+    std::vector<RadixTraceRecord> trace;
+    uint64_t dropped = 0;
+    if (opts.trace.empty() || !RadixTraceLoad(opts.trace.c_str(), trace, &dropped))
+    {
+        std::cerr << "could not read call trace '" << opts.trace << "' (--trace=FILE)\n";
+        return 1;
+    }
+    if (opts.calls && trace.size() > opts.calls)
+        trace.resize(opts.calls);
+
+    uint64_t keyCounts[6] = {};
+    uint32_t maxElements = 1;
+    for (const RadixTraceRecord &r : trace)
+    {
+        keyCounts[std::min<uint8_t>(r.keyType, 5)]++;
+        maxElements = std::max(maxElements, r.elements);
+    }
+    std::cout << "\ntrace: " << trace.size() << " calls (" << dropped << " dropped when recorded), keys";
+    for (int k = 0; k < 6; ++k)
+    {
+        if (keyCounts[k])
+            std::cout << " " << kKeyNames[k] << " " << keyCounts[k];
+    }
+    if (!trace.empty())
+        std::cout << ", span " << std::fixed << std::setprecision(3)
+                  << (trace.back().startNs + trace.back().durationNs - trace.front().startNs) / 1e9 << " s";
+    std::cout << "\n";
+
+    // replay every call on every engine; size class k holds calls of up to 2^k elements
+    const std::vector<const SortEngine *> &engines = opts.engines;
+    const Distribution &dist = *findDistribution("random");
+    CallTimer timer;
+    std::vector<float> source(maxElements), work(maxElements), scratch(maxElements);
+    std::vector<uint64_t> calls(33), elements(33), ascending(33);
+    std::vector<double> traced(33);
+    std::vector<std::vector<double>> replayed(engines.size(), std::vector<double>(33));
+
+    for (size_t c = 0; c < trace.size(); ++c)
+    {
+        const RadixTraceRecord &r = trace[c];
+        uint32_t N = std::max(1u, r.elements);
+        int k = 0;
+        while ((1ull << k) < N)
+            ++k;
+        calls[k]++;
+        elements[k] += N;
+        ascending[k] += r.ascending;
+        traced[k] += double(r.durationNs);
+
+        generate(dist, source.data(), N, kInputSeed, uint32_t(c), false);
+        Philox rng(kInputSeed, uint32_t(c), UINT32_MAX);
+        arrangeAscending(source.data(), N, rng, r.ascending / 255.0);
+
+        for (size_t i = 0; i < engines.size(); ++i)
+        {
+            std::memcpy(work.data(), source.data(), N * sizeof(float));
+            uint64_t t0 = timer.start();
+            float *result = engines[i]->sort(work.data(), scratch.data(), N);
+            uint64_t t1 = timer.stop();
+            replayed[i][k] += timer.ns(t0, t1);
+
+            if (kCheckCorrect && !std::is_sorted(result, result + N))
+                std::cerr << engines[i]->name << " failed on trace call " << c << " (N=" << N << ")\n";
+        }
+    }
+
+    std::cout << "\n=== Replay (milliseconds per size class) ===\n";
+    std::cout << std::setw(12) << "Elements" << std::setw(10) << "Calls" << std::setw(12) << "Elements %"
+              << std::setw(12) << "Ordered %" << std::setw(14) << "Traced";
+    for (const SortEngine *engine : engines)
+        std::cout << std::setw(18) << engine->name;
+    std::cout << "\n";
+
+    uint64_t totalElements = 0, totalCalls = 0, totalAscending = 0;
+    double totalTraced = 0;
+    std::vector<double> totalReplayed(engines.size());
+    for (int k = 0; k <= 32; ++k)
+    {
+        totalElements += elements[k];
+        totalCalls += calls[k];
+        totalAscending += ascending[k];
+        totalTraced += traced[k];
+        for (size_t i = 0; i < engines.size(); ++i)
+            totalReplayed[i] += replayed[i][k];
+    }
+
+    auto printRow = [&](const std::string &label, uint64_t n, uint64_t keys, uint64_t ordered, double tracedNs,
+                        const std::vector<double> &engineNs) {
+        std::cout << std::setw(12) << label << std::setw(10) << n << std::setprecision(1) << std::setw(12)
+                  << 100.0 * keys / std::max<uint64_t>(1, totalElements) << std::setw(12)
+                  << 100.0 * ordered / 255.0 / std::max<uint64_t>(1, n) << std::setprecision(3) << std::setw(14)
+                  << tracedNs / 1e6;
+        for (double ns : engineNs)
+            std::cout << std::setw(18) << ns / 1e6;
+        std::cout << "\n";
+    };
+    for (int k = 0; k <= 32; ++k)
+    {
+        if (!calls[k])
+            continue;
+        std::vector<double> row(engines.size());
+        for (size_t i = 0; i < engines.size(); ++i)
+            row[i] = replayed[i][k];
+        printRow(std::to_string(1ull << k), calls[k], elements[k], ascending[k], traced[k], row);
+    }
+    printRow("total", totalCalls, totalElements, totalAscending, totalTraced, totalReplayed);
+    return 0;
+}
+
+// One --mode=contention run: the timed batches of every tenant, and the hog's bandwidth meanwhile.
+struct TenantRun
+{
+    std::vector<double> throughput; // per tenant: keys of a batch over its median batch time
+    double hogGBs = 0;
+};
+
+// 'tenants' threads, each sorting its own copies of a rotation of 'source' with 'engine' in
+// batches -- copy the inputs in (untimed), sort them all (timed) -- from a common start until every
+// tenant has 'warmup' + 'reps' batches, with the hog (if any) running all the while. Only batches
+// that ended before the first tenant could stop count, so every one ran against all the others. The
+// hog's bandwidth counts over the same span, from the start to the stop, not the tenants' set-up.
+// Each tenant gets at most kMaxTotal / tenants keys (but one input at least).
+TenantRun runTenants(const SortEngine &engine, const Distribution &dist, const std::vector<std::vector<float>> &source,
+                     uint32_t tenants, BandwidthHog *hog, int warmup, int reps)
+{
+    uint32_t N = uint32_t(source[0].size());
+    uint32_t trials = std::max(1u, std::min(uint32_t(source.size()), kMaxTotal / tenants / N));
+
+    std::atomic<bool> go{false}, stop{false};
+    std::vector<std::atomic<int>> timed(tenants);
+    std::vector<std::vector<double>> batches(tenants);
+    for (std::atomic<int> &t : timed)
+        t = 0;
+
+    auto tenant = [&](uint32_t k) {
+        std::vector<std::vector<float>> inputs(trials, std::vector<float>(N));
+        std::vector<float> scratch(
+            engine.scratch == ScratchKind::Caller ? size_t(std::ceil(N * engine.scratchPerElement)) : 0);
+        float *result = nullptr;
+        while (!go.load(std::memory_order_acquire))
+            std::this_thread::yield();
+
+        for (int b = -warmup; !stop.load(std::memory_order_relaxed); ++b)
+        {
+            for (uint32_t t = 0; t < trials; ++t)
+                std::memcpy(inputs[t].data(), source[(k + t) % source.size()].data(), N * sizeof(float));
+            auto t0 = Clock::now();
+            for (uint32_t t = 0; t < trials; ++t)
+                result = engine.sort(inputs[t].data(), scratch.data(), N);
+            double seconds = secondsSince(t0);
+            if (b >= 0 && !stop.load(std::memory_order_relaxed))
+            {
+                batches[k].push_back(seconds);
+                timed[k].store(b + 1, std::memory_order_relaxed);
+            }
+        }
+
+        if (kCheckCorrect && !isSorted(dist, result, N))
+            std::cerr << engine.name << " failed on " << dist.name << " at N=" << N << " (tenant " << k << ")\n";
+    };
+
+    if (hog)
+        hog->start();
+    std::vector<std::thread> pool;
+    for (uint32_t k = 0; k < tenants; ++k)
+        pool.emplace_back(tenant, k);
+    if (hog)
+        hog->lap();
+    go.store(true, std::memory_order_release);
+    for (uint32_t k = 0; k < tenants; ++k)
+    {
+        while (timed[k].load(std::memory_order_relaxed) < reps)
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    stop.store(true, std::memory_order_relaxed);
+
+    TenantRun run;
+    if (hog)
+        run.hogGBs = hog->lap();
+    for (std::thread &th : pool)
+        th.join();
+    if (hog)
+        hog->stop();
+    for (const std::vector<double> &b : batches)
+        run.throughput.push_back(double(N) * trials / summarize(b).median / 1e6);
+    return run;
+}
+
+// Sorting next to other sorts and other memory traffic: every selected engine with --tenants K
+// threads sorting at once, each on its own copies of the inputs, optionally beside --hog threads
+// that do nothing but copy large buffers (BandwidthHog). Per engine, size and K, rows give the
+// aggregate throughput of all tenants, the mean per tenant, the aggregate against one tenant alone
+// on a quiet machine (Scaling), and each tenant's slowdown against that same solo run -- the median
+// tenant's and the worst. With --hog, an 'alone' row shows the quiet solo run and the last column
+// the bandwidth the hog still got. Parallel engines run each tenant on setParallelThreads threads.
+void runContention(const BenchOptions &opts)
+{
+    std::unique_ptr<BandwidthHog> hog;
+    if (opts.hog)
+    {
+        hog.reset(new BandwidthHog(opts.hog));
+        hog->start();
+        std::this_thread::sleep_for(std::chrono::milliseconds(250));
+        std::cout << "\nhog: " << opts.hog << (opts.hog == 1 ? " thread, " : " threads, ") << std::fixed
+                  << std::setprecision(2) << hog->stop() << " GB/s alone\n";
+    }
+    uint32_t most = *std::max_element(opts.tenants.begin(), opts.tenants.end());
+    std::vector<int> allowed = allowedCpus();
+    if (most + opts.hog > allowed.size() && !allowed.empty())
+        std::cerr << "warning: " << most + opts.hog << " threads on " << allowed.size()
+                  << " cpus oversubscribes them; slowdowns include time-slicing\n";
+
+    for (const Distribution *dist : opts.distributions)
+    {
+        std::cout << "\n=== " << dist->label << ", concurrent tenants";
+        if (opts.hog)
+            std::cout << " + " << opts.hog << " hog" << (opts.hog == 1 ? " thread" : " threads");
+        std::cout << " (million elements/sec, " << opts.reps << " batches per tenant) ===\n";
+        std::cout << std::fixed << std::setprecision(2) << std::setw(12) << "Elements" << "  " << std::left
+                  << std::setw(18) << "Engine" << std::right << std::setw(8) << "Tenants" << std::setw(12)
+                  << "Aggregate" << std::setw(12) << "Per tenant" << std::setw(10) << "Scaling" << std::setw(10)
+                  << "Slowdown" << std::setw(10) << "Worst";
+        if (opts.hog)
+            std::cout << std::setw(10) << "Hog GB/s";
+        std::cout << "\n";
+
+        for (int e = opts.minLog2; e <= opts.maxLog2; ++e)
+        {
+            uint32_t N = 1u << e;
+            std::vector<std::vector<float>> source;
+            generateInputs(trialsFor(N), N, *dist, source);
+
+            for (size_t i = 0; i < opts.engines.size(); ++i)
+            {
+                const SortEngine &engine = *opts.engines[i];
+                auto label = [&](bool first) {
+                    std::cout << std::setw(12) << (i == 0 && first ? std::to_string(N) : std::string()) << "  "
+                              << std::left << std::setw(18) << (first ? engine.name : "") << std::right;
+                };
+                if (dist->nans && !engine.totalOrder)
+                {
+                    label(true);
+                    std::cout << std::setw(8) << "n/a" << "  (undefined on NaNs)\n";
+                    continue;
+                }
+
+                TenantRun solo = runTenants(engine, *dist, source, 1, nullptr, opts.warmup, opts.reps);
+                double alone = solo.throughput[0];
+                bool first = true;
+                if (opts.hog)
+                {
+                    label(first);
+                    first = false;
+                    std::cout << std::setw(8) << "alone" << std::setw(12) << alone << std::setw(12) << alone
+                              << std::setw(9) << 1.0 << "x" << std::setw(9) << 1.0 << "x" << std::setw(9) << 1.0
+                              << "x" << std::setw(10) << "" << "\n";
+                }
+
+                for (uint32_t k : opts.tenants)
+                {
+                    TenantRun run =
+                        k == 1 && !opts.hog ? solo : runTenants(engine, *dist, source, k, hog.get(), opts.warmup,
+                                                                opts.reps);
+                    std::vector<double> slowdown;
+                    double aggregate = 0;
+                    for (double t : run.throughput)
+                    {
+                        aggregate += t;
+                        slowdown.push_back(alone / t);
+                    }
+                    std::sort(slowdown.begin(), slowdown.end());
+
+                    label(first);
+                    first = false;
+                    std::cout << std::setw(8) << k << std::setw(12) << aggregate << std::setw(12) << aggregate / k
+                              << std::setw(9) << aggregate / alone << "x" << std::setw(9)
+                              << slowdown[slowdown.size() / 2] << "x" << std::setw(9) << slowdown.back() << "x";
+                    if (opts.hog)
+                        std::cout << std::setw(10) << run.hogGBs;
+                    std::cout << "\n";
+                }
+            }
+        }
+    }
+}
+
+// --mode=firsttouch: what the first sort into fresh scratch pays for its pages. For each engine that
+// sorts into caller scratch, and each size, --reps sorts into scratch from RadixAllocScratch, each
+// with a new buffer: left to fault in during the sort (Fresh), populated by the kernel at mapping time
+// (Populate), and written once per page by parallel threads (Touch); then the steady state, --reps
+// sorts reusing one buffer (Warm). Inputs are copied in untimed. Rows give median microseconds per
+// sort, the page faults a fresh sort took, what Fresh costs over Warm, and what each prefault took
+// when allocating (Setup). With --mlock, the prefaulted buffers are locked as well.
+void runFirstTouch(const BenchOptions &opts)
+{
+    bool lockRefused = false;
+    for (const Distribution *dist : opts.distributions)
+    {
+        std::cout << "\n=== " << dist->label << ", first touch of the scratch (microseconds per sort, " << opts.reps
+                  << " fresh buffers each) ===\n";
+        std::cout << std::fixed << std::setw(12) << "Elements" << "  " << std::left << std::setw(18) << "Engine"
+                  << std::right << std::setw(12) << "Warm" << std::setw(12) << "Fresh" << std::setw(10) << "Faults"
+                  << std::setw(10) << "Fresh +%" << std::setw(12) << "Populate" << std::setw(10) << "Setup"
+                  << std::setw(12) << "Touch" << std::setw(10) << "Setup" << "\n";
+
+        for (int e = opts.minLog2; e <= opts.maxLog2; ++e)
+        {
+            uint32_t N = 1u << e;
+            std::vector<std::vector<float>> source;
+            generateInputs(std::min<uint32_t>(trialsFor(N), uint32_t(opts.reps)), N, *dist, source);
+            std::vector<float> work(N);
+
+            bool firstRow = true;
+            for (const SortEngine *engine : opts.engines)
+            {
+                if (engine->scratch != ScratchKind::Caller || (dist->nans && !engine->totalOrder))
+                    continue;
+                size_t scratchBytes = size_t(std::ceil(N * engine->scratchPerElement)) * sizeof(float);
+
+                // median sort time, faults and allocation time of --reps sorts into fresh buffers
+                // ('fresh') or into one reused, already warm buffer; -1 if a buffer can't be had
+                auto measure = [&](RadixPrefault prefault, bool fresh, double &faults, double &setup) {
+                    RadixScratchOptions options;
+                    options.prefault = prefault;
+                    options.lock = opts.mlock && prefault != RadixPrefault::None;
+                    RadixScratch scratch;
+                    if (!fresh)
+                    {
+                        scratch = RadixAllocScratch(scratchBytes, options);
+                        if (!scratch.data)
+                            return -1.0;
+                        std::memcpy(work.data(), source[0].data(), N * sizeof(float));
+                        engine->sort(work.data(), static_cast<float *>(scratch.data), N);
+                    }
+
+                    std::vector<double> sorts, faultCounts, setups;
+                    float *result = nullptr;
+                    for (int r = 0; r < opts.reps; ++r)
+                    {
+                        std::memcpy(work.data(), source[r % source.size()].data(), N * sizeof(float));
+                        if (fresh)
+                        {
+                            auto t0 = Clock::now();
+                            scratch = RadixAllocScratch(scratchBytes, options);
+                            setups.push_back(secondsSince(t0));
+                            if (!scratch.data)
+                                return -1.0;
+                            lockRefused |= options.lock && !scratch.locked;
+                        }
+                        uint64_t faults0 = minorPageFaults();
+                        auto t0 = Clock::now();
+                        result = engine->sort(work.data(), static_cast<float *>(scratch.data), N);
+                        sorts.push_back(secondsSince(t0));
+                        faultCounts.push_back(double(minorPageFaults() - faults0));
+                        if (kCheckCorrect && !isSorted(*dist, result, N))
+                            std::cerr << engine->name << " failed on " << dist->name << " at N=" << N << "\n";
+                        if (fresh)
+                            RadixFreeScratch(scratch);
+                    }
+                    if (!fresh)
+                        RadixFreeScratch(scratch);
+
+                    faults = summarize(faultCounts).median;
+                    setup = fresh ? summarize(setups).median : 0;
+                    return summarize(sorts).median;
+                };
+
+                double faults = 0, setup = 0, populateSetup = 0, touchSetup = 0;
+                double warm = measure(RadixPrefault::None, false, faults, setup);
+                double fresh = measure(RadixPrefault::None, true, faults, setup);
+                double freshFaults = faults;
+                double populate = measure(RadixPrefault::Populate, true, faults, populateSetup);
+                double touch = measure(RadixPrefault::Touch, true, faults, touchSetup);
+
+                std::cout << std::setw(12) << (firstRow ? std::to_string(N) : std::string()) << "  " << std::left
+                          << std::setw(18) << engine->name << std::right;
+                firstRow = false;
+                if (warm < 0 || fresh < 0 || populate < 0 || touch < 0)
+                {
+                    std::cout << std::setw(12) << "n/a" << "  (could not allocate "
+                              << scratchBytes / 1024 << " KB of scratch" << (opts.mlock ? ", locked" : "") << ")\n";
+                    continue;
+                }
+                std::cout << std::setprecision(2) << std::setw(12)
+                          << warm * 1e6 << std::setw(12) << fresh * 1e6 << std::setprecision(0) << std::setw(10)
+                          << freshFaults << std::setprecision(1) << std::setw(10) << 100.0 * (fresh - warm) / warm
+                          << std::setprecision(2) << std::setw(12) << populate * 1e6 << std::setw(10)
+                          << populateSetup * 1e6 << std::setw(12) << touch * 1e6 << std::setw(10) << touchSetup * 1e6
+                          << "\n";
+            }
+        }
+    }
+    if (lockRefused)
+        std::cerr << "warning: mlock was refused for some buffers (RLIMIT_MEMLOCK); those ran unlocked\n";
+}
+
+// One point of a presortedness sweep: sorted keys with a share displaced, or sorted runs.
+struct PresortPoint
+{
+    const char *series; // "displace", "range" or "runs"
+    double fraction;    // share of keys displaced
+    double range;       // how far, as a fraction of N
+    uint32_t runs;      // sorted runs (0: displaced instead)
+};
+
+// Where adaptive sorts stop paying off: every selected engine on presorted inputs of 2^max-log2
+// keys, sweeping the displaced share (at the mostly-sorted range, 15%), the displacement range (at
+// the mostly-sorted share, 10%) and the number of sorted runs. Each row gives the measured disorder
+// -- inversions as a share of the most possible, runs, and Rem (keys to remove to leave a sorted
+// sequence) as a share of N -- then median throughput per engine; the end of each series lists
+// where the fastest engine changes.
+void runPresorted(const BenchOptions &opts)
+{
+    static const Distribution kPresorted = {"presorted", "Presorted Input", false, nullptr, nullptr};
+
+    std::vector<PresortPoint> points;
+    for (double f : opts.displace)
+        points.push_back({"displace", f, 0.15, 0});
+    for (double r : opts.displaceRange)
+        points.push_back({"range", 0.10, r, 0});
+    for (uint32_t k : opts.runs)
+        points.push_back({"runs", 0.0, 0.0, k});
+
+    const std::vector<const SortEngine *> &engines = opts.engines;
+    uint32_t N = 1u << opts.maxLog2;
+    uint32_t trials = trialsFor(N);
+
+    std::cout << "\n=== Presorted Input, " << N << " elements (million elements/sec, " << opts.reps
+              << " repetitions) ===\n";
+    std::cout << std::fixed << std::setprecision(2) << std::left << std::setw(10) << "Series" << std::right
+              << std::setw(10) << "Displ %" << std::setw(10) << "Range %" << std::setw(8) << "Runs" << std::setw(10)
+              << "Inv %" << std::setw(10) << "Runs" << std::setw(10) << "Rem %";
+    for (const SortEngine *engine : engines)
+        std::cout << std::setw(std::max<int>(12, int(std::strlen(engine->name)) + 2)) << engine->name;
+    std::cout << "  Fastest\n";
+
+    std::vector<std::vector<float>> source, inputs;
+    inputs.reserve(kMaxTrials);
+    std::mt19937 orderRng(4321);
+
+    std::vector<std::string> crossovers;
+    const SortEngine *lastWinner = nullptr;
+    for (size_t p = 0; p < points.size(); ++p)
+    {
+        const PresortPoint &pt = points[p];
+        if (p > 0 && std::strcmp(points[p - 1].series, pt.series) != 0)
+            lastWinner = nullptr;
+
+        // random keys, arranged per trial
+        generateInputs(trials, N, *findDistribution("random"), source);
+        parallelFor(trials, 1, [&](size_t begin, size_t end) {
+            for (size_t t = begin; t < end; ++t)
+            {
+                Philox rng(kInputSeed, uint32_t(t), UINT32_MAX);
+                if (pt.runs)
+                    arrangeRuns(source[t].data(), N, pt.runs);
+                else
+                    arrangeDisplaced(source[t].data(), N, rng, pt.fraction, pt.range);
+            }
+        });
+        DisorderMetrics m = measureDisorder(source[0].data(), N);
+
+        std::vector<BenchRecord> records;
+        timeRepetitions(engines, kPresorted, CacheState::Batch, source, opts.warmup, opts.reps, orderRng, nullptr,
+                        nullptr, inputs, records);
+
+        std::cout << std::left << std::setw(10) << pt.series << std::right;
+        if (pt.runs)
+            std::cout << std::setw(10) << "-" << std::setw(10) << "-" << std::setw(8) << pt.runs;
+        else
+            std::cout << std::setw(10) << 100.0 * pt.fraction << std::setw(10) << 100.0 * pt.range << std::setw(8)
+                      << "-";
+        std::cout << std::setw(10) << 100.0 * m.inversionRatio(N) << std::setw(10) << m.runs << std::setw(10)
+                  << 100.0 * double(m.rem) / N;
+
+        const SortEngine *winner = nullptr;
+        double best = 0.0;
+        for (const SortEngine *engine : engines)
+        {
+            std::vector<double> samples;
+            for (const BenchRecord &r : records)
+            {
+                if (r.engine == engine->name)
+                    samples.push_back(double(N) * trials / r.seconds / 1e6);
+            }
+            double eps = summarize(samples).median;
+            std::cout << std::setw(std::max<int>(12, int(std::strlen(engine->name)) + 2)) << eps;
+            if (eps > best)
+            {
+                best = eps;
+                winner = engine;
+            }
+        }
+        std::cout << "  " << winner->name << "\n";
+
+        if (lastWinner && winner != lastWinner)
+        {
+            std::ostringstream line;
+            line << pt.series << ": " << lastWinner->name << " -> " << winner->name << " between ";
+            if (pt.runs)
+                line << points[p - 1].runs << " and " << pt.runs << " runs";
+            else if (std::strcmp(pt.series, "displace") == 0)
+                line << 100.0 * points[p - 1].fraction << "% and " << 100.0 * pt.fraction << "% displaced";
+            else
+                line << 100.0 * points[p - 1].range << "% and " << 100.0 * pt.range << "% range";
+            crossovers.push_back(line.str());
+        }
+        lastWinner = winner;
+    }
+
+    std::cout << "\nCrossovers:" << (crossovers.empty() ? " none\n" : "\n");
+    for (const std::string &line : crossovers)
+        std::cout << "  " << line << "\n";
+}
+
+// Callers that want the result in their own array: RadixSort11 followed by the memcpy back out of
+// 'sorted', against the in-place plan (RadixOptions::resultInPlace). The copy's cost is the
+// difference between the first two columns; 'Copied' counts the bytes it moves per sort.
+void runInPlace(const BenchOptions &opts)
+{
+    std::vector<std::vector<float>> source, inputs;
+    inputs.reserve(kMaxTrials);
+
+    RadixOptions inPlace;
+    inPlace.resultInPlace = true;
+
+    for (const Distribution *dist : opts.distributions)
+    {
+        std::cout << "\n=== " << dist->label << ", result in caller's array (million elements/sec) ===\n";
+        std::cout << std::fixed << std::setprecision(2) << std::setw(12) << "Elements" << std::setw(14) << "Radix11"
+                  << std::setw(16) << "Radix11+copy" << std::setw(10) << "Copy %" << std::setw(14) << "Copied KB"
+                  << std::setw(14) << "In-place" << std::setw(12) << "Speedup"
+                  << "\n";
+
+        for (int e = opts.minLog2; e <= opts.maxLog2; ++e)
+        {
+            uint32_t N = 1u << e;
+            uint32_t trials = trialsFor(N);
+            std::vector<float> scratch(N);
+            generateInputs(trials, N, *dist, source);
+
+            // --- RadixSort11, result left in scratch
+            copyInputs(source, inputs);
+            auto t0 = Clock::now();
+            for (uint32_t t = 0; t < trials; ++t)
+            {
+                RadixSort11(inputs[t].data(), scratch.data(), N);
+            }
+            double durRadix = secondsSince(t0);
+
+            // --- RadixSort11 + memcpy back into the caller's array
+            copyInputs(source, inputs);
+            t0 = Clock::now();
+            for (uint32_t t = 0; t < trials; ++t)
+            {
+                RadixSort11(inputs[t].data(), scratch.data(), N);
+                std::memcpy(inputs[t].data(), scratch.data(), N * sizeof(float));
+            }
+            double durCopy = secondsSince(t0);
+
+            if (kCheckCorrect)
+            {
+                if (!isSorted(*dist, inputs.back().data(), N))
+                    std::cerr << "RadixSort11+memcpy failed at N=" << N << "\n";
+            }
+
+            // --- in-place plan
+            copyInputs(source, inputs);
+            t0 = Clock::now();
+            for (uint32_t t = 0; t < trials; ++t)
+            {
+                RadixSort(inputs[t], scratch, inPlace);
+            }
+            double durInPlace = secondsSince(t0);
+
+            if (kCheckCorrect)
+            {
+                if (!isSorted(*dist, inputs.back().data(), N))
+                    std::cerr << "RadixSort (in place) failed at N=" << N << "\n";
+            }
+
+            double elems = double(N) * trials / 1e6;
+            double copyShare = 100.0 * std::max(0.0, durCopy - durRadix) / durCopy;
+
+            std::cout << std::setw(12) << N << std::setw(14) << elems / durRadix << std::setw(16) << elems / durCopy
+                      << std::setw(10) << copyShare << std::setw(14) << N * sizeof(float) / 1024.0 << std::setw(14)
+                      << elems / durInPlace << std::setw(11) << durCopy / durInPlace << "x\n";
+        }
+    }
+}
+
+// Normal vs streaming (non-temporal) stores in the last pass. After every sort a follow-up workload
+// re-reads a small working set that was hot before the sort; its time shows how much of the cache
+// the sort's output evicted.
+void runStream(const BenchOptions &opts)
+{
+    std::vector<std::vector<float>> source, inputs;
+    inputs.reserve(kMaxTrials);
+
+    std::vector<float> hot(kHotSetBytes / sizeof(float), 1.0f);
+    volatile float sink = 0.0f;
+    auto sumHot = [&hot]() {
+        float sum = 0.0f;
+        for (float x : hot)
+            sum += x;
+        return sum;
+    };
+
+    const RadixOptions variants[2] = {RadixOptions(), [] {
+                                          RadixOptions o;
+                                          o.streamFinalPass = true;
+                                          return o;
+                                      }()};
+
+    for (const Distribution *dist : opts.distributions)
+    {
+        std::cout << "\n=== " << dist->label << ", streaming final pass (million elements/sec; follow-up: us to re-read "
+                  << kHotSetBytes / 1024 << " KB) ===\n";
+        std::cout << std::fixed << std::setprecision(2) << std::setw(12) << "Elements" << std::setw(14) << "Radix"
+                  << std::setw(14) << "Radix NT" << std::setw(12) << "Speedup" << std::setw(14) << "Follow-up"
+                  << std::setw(14) << "Follow-up NT"
+                  << "\n";
+
+        for (int e = opts.minLog2; e <= opts.maxLog2; ++e)
+        {
+            uint32_t N = 1u << e;
+            uint32_t trials = trialsFor(N);
+            std::vector<float> scratch(N);
+            generateInputs(trials, N, *dist, source);
+
+            double durSort[2] = {}, durFollow[2] = {};
+            for (int v = 0; v < 2; ++v)
+            {
+                copyInputs(source, inputs);
+                RadixSortResult<float> result;
+                for (uint32_t t = 0; t < trials; ++t)
+                {
+                    sink = sink + sumHot(); // warm the working set
+
+                    auto t0 = Clock::now();
+                    result = RadixSort(inputs[t], scratch, variants[v]);
+                    durSort[v] += secondsSince(t0);
+
+                    t0 = Clock::now();
+                    sink = sink + sumHot();
+                    durFollow[v] += secondsSince(t0);
+                }
+
+                if (kCheckCorrect)
+                {
+                    if (!isSorted(*dist, result.begin(), N))
+                        std::cerr << "RadixSort (" << (v ? "streaming" : "normal") << " stores) failed at N=" << N
+                                  << "\n";
+                }
+            }
+
+            double elems = double(N) * trials / 1e6;
+            std::cout << std::setw(12) << N << std::setw(14) << elems / durSort[0] << std::setw(14)
+                      << elems / durSort[1] << std::setw(11) << durSort[0] / durSort[1] << "x" << std::setw(14)
+                      << 1e6 * durFollow[0] / trials << std::setw(14) << 1e6 * durFollow[1] / trials << "\n";
+        }
+    }
+}
+
+// Sweep of the runtime prefetch settings: every combination of source / destination distance and
+// hint from the command line, relative to no prefetching at all.
+void runPrefetch(const BenchOptions &opts)
+{
+    std::vector<std::vector<float>> source, inputs;
+    inputs.reserve(kMaxTrials);
+
+    std::vector<RadixPrefetch> configs;
+    for (uint32_t src : opts.pfSrc)
+        for (RadixPrefetchHint srcHint : opts.pfSrcHint)
+            for (uint32_t dst : opts.pfDst)
+                for (RadixPrefetchHint dstHint : opts.pfDstHint)
+                {
+                    RadixPrefetch pf;
+                    pf.srcDistance = src;
+                    pf.srcHint = srcHint;
+                    pf.dstDistance = dst;
+                    pf.dstHint = dstHint;
+                    configs.push_back(pf);
+                }
+
+    for (const Distribution *dist : opts.distributions)
+    {
+        std::cout << "\n=== " << dist->label << ", prefetch sweep (million elements/sec) ===\n";
+        std::cout << std::fixed << std::setprecision(2) << std::setw(12) << "Elements" << std::setw(10) << "Src"
+                  << std::setw(6) << "Hint" << std::setw(10) << "Dst" << std::setw(6) << "Hint" << std::setw(14)
+                  << "Radix" << std::setw(12) << "vs off"
+                  << "\n";
+
+        for (int e = opts.minLog2; e <= opts.maxLog2; ++e)
+        {
+            uint32_t N = 1u << e;
+            uint32_t trials = trialsFor(N);
+            std::vector<float> scratch(N);
+            generateInputs(trials, N, *dist, source);
+
+            // time one configuration over a fresh copy of the inputs
+            auto measure = [&](const RadixPrefetch &pf) {
+                RadixOptions options;
+                options.prefetch = pf;
+
+                copyInputs(source, inputs);
+                RadixSortResult<float> result;
+                auto t0 = Clock::now();
+                for (uint32_t t = 0; t < trials; ++t)
+                {
+                    result = RadixSort(inputs[t], scratch, options);
+                }
+                double dur = secondsSince(t0);
+
+                if (kCheckCorrect)
+                {
+                    if (!isSorted(*dist, result.begin(), N))
+                        std::cerr << "RadixSort (prefetch " << pf.srcDistance << "/" << pf.dstDistance
+                                  << ") failed at N=" << N << "\n";
+                }
+                return double(N) * trials / dur / 1e6;
+            };
+
+            double epsOff = measure(RadixPrefetch{0, RadixPrefetchHint::T0, 0, RadixPrefetchHint::T0});
+            for (const RadixPrefetch &pf : configs)
+            {
+                double eps = measure(pf);
+                std::cout << std::setw(12) << N << std::setw(10) << pf.srcDistance << std::setw(6)
+                          << kHintNames[int(pf.srcHint)] << std::setw(10) << pf.dstDistance << std::setw(6)
+                          << kHintNames[int(pf.dstHint)] << std::setw(14) << eps << std::setw(11) << eps / epsOff
+                          << "x\n";
+            }
+        }
+    }
+}
+
+// Throughput of RadixSort with 'options' on random input of size N: best of a few repetitions over a
+// reduced trial budget, enough to rank configurations.
+double measureRadix(uint32_t N, const RadixOptions &options, std::vector<std::vector<float>> &inputs)
+{
+    static constexpr int kRepetitions = 3;
+    uint32_t trials = std::min(kMaxTrials, std::max(1u, kMaxTotal / 4 / N));
+    std::vector<float> scratch(N);
+
+    // inputs for the size being tuned, kept across calls
+    static std::vector<std::vector<float>> source;
+    if (source.size() != trials || source[0].size() != N)
+        generateInputs(trials, N, *findDistribution("random"), source);
+
+    double best = 0.0;
+    for (int r = 0; r < kRepetitions; ++r)
+    {
+        copyInputs(source, inputs);
+        RadixSortResult<float> result;
+        auto t0 = Clock::now();
+        for (uint32_t t = 0; t < trials; ++t)
+        {
+            result = RadixSort(inputs[t], scratch, options);
+        }
+        double dur = secondsSince(t0);
+
+        if (kCheckCorrect)
+        {
+            if (!std::is_sorted(result.begin(), result.end()))
+                std::cerr << "RadixSort failed at N=" << N << " while tuning\n";
+        }
+        best = std::max(best, double(N) * trials / dur / 1e6);
+    }
+    return best;
+}
+
+// Per-machine autotuning: finds the insertion-sort cutoff, then for every size in the ladder tunes
+// digit width, source prefetch, destination prefetch and thread count in turn (each coordinate
+// with the others held at their best so far). Writes the profile to --tuning-out and compares it
+// with the compiled defaults.
+void runAutotune(const BenchOptions &opts)
+{
+    std::vector<std::vector<float>> inputs;
+    inputs.reserve(kMaxTrials);
+
+    const RadixTuning defaults = RadixDefaultTuning();
+    RadixTuning tuned;
+
+    // --- small-N cutoff: first size at which the radix passes beat insertion sort
+    std::cout << "\n=== Autotune: small-sort cutoff (million elements/sec) ===\n";
+    std::cout << std::fixed << std::setprecision(2) << std::setw(12) << "Elements" << std::setw(14) << "Insertion"
+              << std::setw(14) << "Radix"
+              << "\n";
+    tuned.smallSortThreshold = 0;
+    for (uint32_t N = 4; N <= 1024; N *= 2)
+    {
+        RadixOptions insertion, radix;
+        insertion.smallSortThreshold = N + 1;
+        radix.smallSortThreshold = 0;
+        radix.digitBits = 8;
+        double epsInsertion = measureRadix(N, insertion, inputs);
+        double epsRadix = measureRadix(N, radix, inputs);
+        std::cout << std::setw(12) << N << std::setw(14) << epsInsertion << std::setw(14) << epsRadix << "\n";
+
+        if (epsRadix >= epsInsertion)
+        {
+            tuned.smallSortThreshold = N;
+            break;
+        }
+        tuned.smallSortThreshold = N * 2;
+    }
+
+    // --- per-size settings
+    std::vector<uint32_t> threadCounts = {1};
+    for (uint32_t t = 2; t <= std::thread::hardware_concurrency(); t *= 2)
+        threadCounts.push_back(t);
+
+    std::cout << "\n=== Autotune: per-size settings (million elements/sec) ===\n";
+    std::cout << std::setw(12) << "Elements" << std::setw(6) << "Bits" << std::setw(10) << "Src" << std::setw(6)
+              << "Hint" << std::setw(10) << "Dst" << std::setw(6) << "Hint" << std::setw(9) << "Threads"
+              << std::setw(14) << "Radix"
+              << "\n";
+
+    int minLog2 = opts.minLog2;
+    while (minLog2 < opts.maxLog2 && (1u << (minLog2 + 1)) <= tuned.smallSortThreshold)
+        ++minLog2;
+    for (int e = minLog2; e <= opts.maxLog2; ++e)
+    {
+        uint32_t N = 1u << e;
+
+        RadixTuningEntry entry;
+        entry.maxElements = e == opts.maxLog2 ? UINT32_MAX : N;
+
+        RadixOptions options;
+        options.smallSortThreshold = 0;
+        auto measure = [&](const RadixTuningEntry &candidate) {
+            options.digitBits = candidate.digitBits;
+            options.prefetch = candidate.prefetch;
+            options.threads = candidate.threads;
+            return measureRadix(N, options, inputs);
+        };
+
+        // keep whichever candidate of one coordinate is fastest
+        double best = 0.0;
+        auto consider = [&](const RadixTuningEntry &candidate) {
+            double eps = measure(candidate);
+            if (eps > best)
+            {
+                best = eps;
+                entry = candidate;
+            }
+        };
+
+        for (uint32_t bits : {8u, 11u, 16u})
+        {
+            RadixTuningEntry c = entry;
+            c.digitBits = bits;
+            consider(c);
+        }
+        RadixTuningEntry base = entry;
+        for (uint32_t src : opts.pfSrc)
+            for (RadixPrefetchHint hint : opts.pfSrcHint)
+            {
+                RadixTuningEntry c = base;
+                c.prefetch.srcDistance = src;
+                c.prefetch.srcHint = hint;
+                consider(c);
+            }
+        base = entry;
+        for (uint32_t dst : opts.pfDst)
+            for (RadixPrefetchHint hint : opts.pfDstHint)
+            {
+                RadixTuningEntry c = base;
+                c.prefetch.dstDistance = dst;
+                c.prefetch.dstHint = hint;
+                consider(c);
+            }
+        base = entry;
+        for (uint32_t threads : threadCounts)
+        {
+            RadixTuningEntry c = base;
+            c.threads = threads;
+            consider(c);
+        }
+
+        tuned.entries.push_back(entry);
+        std::cout << std::setw(12) << N << std::setw(6) << entry.digitBits << std::setw(10)
+                  << entry.prefetch.srcDistance << std::setw(6) << kHintNames[int(entry.prefetch.srcHint)]
+                  << std::setw(10) << entry.prefetch.dstDistance << std::setw(6)
+                  << kHintNames[int(entry.prefetch.dstHint)] << std::setw(9) << entry.threads << std::setw(14) << best
+                  << "\n";
+    }
+
+    if (tuned.entries.empty())
+        tuned.entries = defaults.entries;
+
+    if (RadixSaveTuning(opts.tuningOut.c_str(), tuned))
+        std::cout << "\nwrote tuning profile to " << opts.tuningOut << "\n";
+    else
+        std::cerr << "could not write tuning profile to " << opts.tuningOut << "\n";
+
+    // --- tuned vs compiled defaults
+    std::cout << "\n=== Autotune: tuned vs default (million elements/sec) ===\n";
+    std::cout << std::setw(12) << "Elements" << std::setw(14) << "Default" << std::setw(14) << "Tuned"
+              << std::setw(12) << "Speedup"
+              << "\n";
+    for (int e = opts.minLog2; e <= opts.maxLog2; ++e)
+    {
+        uint32_t N = 1u << e;
+        RadixSetTuning(defaults);
+        double epsDefault = measureRadix(N, RadixOptions(), inputs);
+        RadixSetTuning(tuned);
+        double epsTuned = measureRadix(N, RadixOptions(), inputs);
+        std::cout << std::setw(12) << N << std::setw(14) << epsDefault << std::setw(14) << epsTuned << std::setw(11)
+                  << epsTuned / epsDefault << "x\n";
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
+// Main function
+
+int main(int argc, char **argv)
+{
+    BenchOptions opts;
+    if (!parseArgs(argc, argv, opts))
+        return 1;
+
+    if (opts.listEngines)
+    {
+        listEngines();
+        return 0;
+    }
+    if (opts.listDistributions)
+    {
+        listDistributions();
+        return 0;
+    }
+
+    if (opts.pin >= 0 && !pinToCpu(opts.pin))
+        std::cerr << "warning: could not pin to cpu " << opts.pin << "\n";
+    else if (opts.pin >= 0)
+    {
+        // threads started from here on inherit the one-cpu mask
+        bool parallel = !opts.threads.empty() || opts.mode == "contention";
+        for (const SortEngine *engine : opts.engines)
+            parallel |= engine->parallel;
+        if (parallel)
+            std::cerr << "warning: --pin=" << opts.pin << " confines every thread the bench starts to that cpu: "
+                      << "parallel engines, contention tenants and hog threads all share it\n";
+    }
+    warnAboutNoise(opts.pin >= 0 ? opts.pin : currentCpu());
+
+    // the library never loads a profile by itself: only --tuning, or $RADIX_TUNING without it
+    if (opts.tuning.empty())
+    {
+        const char *path = std::getenv("RADIX_TUNING");
+        opts.tuning = path ? path : "";
+    }
+    if (!opts.tuning.empty())
+    {
+        RadixTuning tuning;
+        if (!RadixLoadTuning(opts.tuning.c_str(), tuning))
+        {
+            std::cerr << "could not load tuning profile " << opts.tuning << "\n";
+            return 1;
+        }
+        RadixSetTuning(tuning);
+    }
+
+    if (!opts.traceOut.empty())
+        RadixTraceStart();
+    if (!opts.timeline.empty())
+        RadixTimelineStart();
+    if (opts.telemetry)
+    {
+        if (RadixTelemetryStart(opts.telemetryName.c_str()))
+            std::cerr << "telemetry: " << RadixTelemetryName() << " (read it with radix-stat), ";
+        else
+            std::cerr << "warning: no shared memory for telemetry; counting in private memory, ";
+        std::cerr << std::fixed << std::setprecision(2) << 100.0 * telemetryOverhead()
+                  << "% overhead at N=64\n";
+    }
+
+    if (!opts.baseline.empty())
+    {
+        // non-zero exit on regressions (or an unreadable baseline)
+        int regressions = runBaseline(opts);
+        finishTrace(opts);
+        return regressions == 0 ? 0 : regressions < 0 ? 1 : 2;
+    }
+
+    int status = 0;
+    if (!opts.threads.empty())
+        runThreadScaling(opts);
+    else if (opts.mode == "inplace")
+        runInPlace(opts);
+    else if (opts.mode == "stream")
+        runStream(opts);
+    else if (opts.mode == "prefetch")
+        runPrefetch(opts);
+    else if (opts.mode == "autotune")
+        runAutotune(opts);
+    else if (opts.mode == "presorted")
+        runPresorted(opts);
+    else if (opts.mode == "roofline")
+        runRoofline(opts);
+    else if (opts.mode == "latency")
+        runLatency(opts);
+    else if (opts.mode == "replay")
+        status = runReplay(opts);
+    else if (opts.mode == "contention")
+        runContention(opts);
+    else if (opts.mode == "firsttouch")
+        runFirstTouch(opts);
+    else
+        runThroughput(opts);
+
+    finishTrace(opts);
+    return status;
 }
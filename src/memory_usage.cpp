@@ -0,0 +1,377 @@
+// memory_usage.cpp
+// Heap, stack and resident set accounting for --memory. Replaces the global allocation functions,
+// so every operator new in the program -- engines, the standard library, TBB -- is counted while a
+// MemoryMeter region runs.
+
+#include "memory_usage.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+#if defined(__linux__) || defined(__APPLE__)
+#include <sys/resource.h>
+#endif
+
+#if defined(_MSC_VER)
+#include <malloc.h>
+#define MEMORY_NOINLINE __declspec(noinline)
+#define MEMORY_ALLOCA _alloca
+#else
+#define MEMORY_NOINLINE __attribute__((noinline))
+#define MEMORY_ALLOCA __builtin_alloca
+#endif
+
+// ------------------------------------------------------------------------------------------------
+// Counting allocator
+
+static std::atomic<bool> gCounting{false}; // inside a MemoryMeter region
+static std::atomic<uint64_t> gAllocations{0};
+static std::atomic<uint64_t> gBytes{0};
+static std::atomic<uint64_t> gLive{0};
+static std::atomic<uint64_t> gPeak{0};
+
+// every block carries its size just below the pointer handed out, in a header that keeps the
+// requested alignment; blocks allocated while nothing counts carry 0, so freeing them later doesn't
+// lower the live count
+static constexpr size_t kHeaderBytes = __STDCPP_DEFAULT_NEW_ALIGNMENT__;
+
+static void *allocate(size_t size, size_t align)
+{
+    size_t header = std::max(align, kHeaderBytes);
+    void *block;
+    if (align <= kHeaderBytes)
+        block = std::malloc(header + size);
+    else
+    {
+#if defined(_WIN32)
+        block = _aligned_malloc(header + size, align);
+#else
+        block = std::aligned_alloc(align, (header + size + align - 1) & ~(align - 1));
+#endif
+    }
+    if (!block)
+        return nullptr;
+
+    char *p = static_cast<char *>(block) + header;
+    if (!gCounting.load(std::memory_order_relaxed))
+    {
+        reinterpret_cast<size_t *>(p)[-1] = 0;
+        return p;
+    }
+
+    gAllocations.fetch_add(1, std::memory_order_relaxed);
+    gBytes.fetch_add(size, std::memory_order_relaxed);
+    uint64_t live = gLive.fetch_add(size, std::memory_order_relaxed) + size;
+    uint64_t peak = gPeak.load(std::memory_order_relaxed);
+    while (live > peak && !gPeak.compare_exchange_weak(peak, live, std::memory_order_relaxed))
+    {
+    }
+    reinterpret_cast<size_t *>(p)[-1] = size;
+    return p;
+}
+
+static void release(void *p, size_t align)
+{
+    if (!p)
+        return;
+    size_t header = std::max(align, kHeaderBytes);
+    if (size_t counted = reinterpret_cast<size_t *>(p)[-1])
+        gLive.fetch_sub(counted, std::memory_order_relaxed);
+
+    void *block = static_cast<char *>(p) - header;
+    if (align <= kHeaderBytes)
+        std::free(block);
+    else
+    {
+#if defined(_WIN32)
+        _aligned_free(block);
+#else
+        std::free(block);
+#endif
+    }
+}
+
+// the build has no exceptions to throw std::bad_alloc with
+static void *allocateOrDie(size_t size, size_t align)
+{
+    void *p = allocate(size, align);
+    if (!p)
+    {
+        std::fprintf(stderr, "out of memory allocating %zu bytes\n", size);
+        std::abort();
+    }
+    return p;
+}
+
+void *operator new(size_t size)
+{
+    return allocateOrDie(size, kHeaderBytes);
+}
+
+void *operator new[](size_t size)
+{
+    return allocateOrDie(size, kHeaderBytes);
+}
+
+void *operator new(size_t size, std::align_val_t align)
+{
+    return allocateOrDie(size, size_t(align));
+}
+
+void *operator new[](size_t size, std::align_val_t align)
+{
+    return allocateOrDie(size, size_t(align));
+}
+
+void *operator new(size_t size, const std::nothrow_t &) noexcept
+{
+    return allocate(size, kHeaderBytes);
+}
+
+void *operator new[](size_t size, const std::nothrow_t &) noexcept
+{
+    return allocate(size, kHeaderBytes);
+}
+
+void *operator new(size_t size, std::align_val_t align, const std::nothrow_t &) noexcept
+{
+    return allocate(size, size_t(align));
+}
+
+void *operator new[](size_t size, std::align_val_t align, const std::nothrow_t &) noexcept
+{
+    return allocate(size, size_t(align));
+}
+
+void operator delete(void *p) noexcept
+{
+    release(p, kHeaderBytes);
+}
+
+void operator delete[](void *p) noexcept
+{
+    release(p, kHeaderBytes);
+}
+
+void operator delete(void *p, size_t) noexcept
+{
+    release(p, kHeaderBytes);
+}
+
+void operator delete[](void *p, size_t) noexcept
+{
+    release(p, kHeaderBytes);
+}
+
+void operator delete(void *p, const std::nothrow_t &) noexcept
+{
+    release(p, kHeaderBytes);
+}
+
+void operator delete[](void *p, const std::nothrow_t &) noexcept
+{
+    release(p, kHeaderBytes);
+}
+
+void operator delete(void *p, std::align_val_t align) noexcept
+{
+    release(p, size_t(align));
+}
+
+void operator delete[](void *p, std::align_val_t align) noexcept
+{
+    release(p, size_t(align));
+}
+
+void operator delete(void *p, size_t, std::align_val_t align) noexcept
+{
+    release(p, size_t(align));
+}
+
+void operator delete[](void *p, size_t, std::align_val_t align) noexcept
+{
+    release(p, size_t(align));
+}
+
+void operator delete(void *p, std::align_val_t align, const std::nothrow_t &) noexcept
+{
+    release(p, size_t(align));
+}
+
+void operator delete[](void *p, std::align_val_t align, const std::nothrow_t &) noexcept
+{
+    release(p, size_t(align));
+}
+
+HeapCounters heapCounters()
+{
+    HeapCounters c;
+    c.allocations = gAllocations.load(std::memory_order_relaxed);
+    c.bytes = gBytes.load(std::memory_order_relaxed);
+    c.live = gLive.load(std::memory_order_relaxed);
+    c.peak = gPeak.load(std::memory_order_relaxed);
+    return c;
+}
+
+void setHeapCounting(bool on)
+{
+    gCounting.store(on, std::memory_order_relaxed);
+}
+
+void resetHeapPeak()
+{
+    gPeak.store(gLive.load(std::memory_order_relaxed), std::memory_order_relaxed);
+}
+
+// ------------------------------------------------------------------------------------------------
+// Resident set
+
+// a "Vm...:  1234 kB" line of /proc/self/status in bytes, 0 if it isn't there (stdio rather than
+// streams: reading it must not allocate through the counted operator new)
+static size_t procStatusBytes(const char *field)
+{
+    size_t bytes = 0;
+    if (std::FILE *f = std::fopen("/proc/self/status", "r"))
+    {
+        size_t len = std::strlen(field);
+        char line[256];
+        while (std::fgets(line, sizeof(line), f))
+        {
+            if (std::strncmp(line, field, len) == 0 && line[len] == ':')
+            {
+                bytes = size_t(std::strtoull(line + len + 1, nullptr, 10)) * 1024;
+                break;
+            }
+        }
+        std::fclose(f);
+    }
+    return bytes;
+}
+
+size_t residentBytes()
+{
+    return procStatusBytes("VmRSS");
+}
+
+size_t residentPeakBytes()
+{
+    size_t bytes = procStatusBytes("VmHWM");
+#if defined(__linux__) || defined(__APPLE__)
+    if (bytes == 0)
+    {
+        rusage usage;
+        if (getrusage(RUSAGE_SELF, &usage) == 0)
+        {
+#if defined(__APPLE__)
+            bytes = size_t(usage.ru_maxrss); // bytes on macOS, kilobytes on Linux
+#else
+            bytes = size_t(usage.ru_maxrss) * 1024;
+#endif
+        }
+    }
+#endif
+    return bytes;
+}
+
+uint64_t minorPageFaults()
+{
+#if defined(__linux__) || defined(__APPLE__)
+    rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) == 0)
+        return uint64_t(usage.ru_minflt);
+#endif
+    return 0;
+}
+
+bool resetResidentPeak()
+{
+    std::FILE *f = std::fopen("/proc/self/clear_refs", "w");
+    if (!f)
+        return false;
+    bool ok = std::fputs("5", f) >= 0;
+    return std::fclose(f) == 0 && ok;
+}
+
+// ------------------------------------------------------------------------------------------------
+// Stack probe
+
+// Painted below the caller's frame before a region; the deepest byte that no longer holds the paint
+// afterwards is how far the region's stack reached. Deeper than this reads as all of it.
+static constexpr size_t kStackProbeBytes = 128 * 1024;
+static constexpr unsigned char kStackPaint = 0x5a;
+static uintptr_t gStackProbe = 0; // lowest painted address
+
+MEMORY_NOINLINE static void paintStack()
+{
+    volatile unsigned char *p = static_cast<unsigned char *>(MEMORY_ALLOCA(kStackProbeBytes));
+    for (size_t i = 0; i < kStackProbeBytes; ++i)
+        p[i] = kStackPaint;
+    gStackProbe = reinterpret_cast<uintptr_t>(p);
+}
+
+MEMORY_NOINLINE static size_t stackDepth()
+{
+    // move the stack pointer below the painted bytes before reading them
+    volatile unsigned char *below = static_cast<unsigned char *>(MEMORY_ALLOCA(kStackProbeBytes + 4096));
+    below[0] = 0;
+
+    const volatile unsigned char *p = reinterpret_cast<const volatile unsigned char *>(gStackProbe);
+    size_t i = 0;
+    while (i < kStackProbeBytes && p[i] == kStackPaint)
+        ++i;
+    return kStackProbeBytes - i;
+}
+
+// ------------------------------------------------------------------------------------------------
+// MemoryMeter
+
+MemoryUsage &MemoryUsage::operator+=(const MemoryUsage &other)
+{
+    valid |= other.valid;
+    allocations += other.allocations;
+    heapPeak = std::max(heapPeak, other.heapPeak);
+    stackPeak = std::max(stackPeak, other.stackPeak);
+    rssPeak = std::max(rssPeak, other.rssPeak);
+    return *this;
+}
+
+MemoryMeter::MemoryMeter()
+{
+    resetsPeak_ = resetResidentPeak();
+    if (!resetsPeak_)
+        status_ = "can't reset the resident set high-water mark (/proc/self/clear_refs); RSS growth only "
+                  "counts past the process's previous peak";
+}
+
+MEMORY_NOINLINE void MemoryMeter::start()
+{
+    if (resetsPeak_)
+        resetResidentPeak();
+    resident_ = resetsPeak_ ? residentBytes() : residentPeakBytes();
+    paintStack();
+
+    resetHeapPeak();
+    HeapCounters heap = heapCounters();
+    allocations_ = heap.allocations;
+    live_ = heap.live;
+    setHeapCounting(true);
+}
+
+MEMORY_NOINLINE MemoryUsage MemoryMeter::stop()
+{
+    setHeapCounting(false);
+    HeapCounters heap = heapCounters();
+
+    MemoryUsage usage;
+    usage.valid = true;
+    usage.allocations = heap.allocations - allocations_;
+    usage.heapPeak = heap.peak > live_ ? heap.peak - live_ : 0;
+    usage.stackPeak = stackDepth();
+    size_t peak = residentPeakBytes();
+    usage.rssPeak = peak > resident_ ? peak - resident_ : 0;
+    return usage;
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+// Memory an engine needs beyond its input (--memory): heap allocations, counted by the global
+// operator new / delete this file's translation unit replaces; the calling thread's stack, by
+// painting it before the region and looking for the deepest overwritten byte after; and resident set
+// growth, sampled from /proc/self/status (getrusage where that isn't available). Scratch handed in
+// by the caller is none of these: it is allocated and touched before the region starts.
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// Memory used over one or more regions; valid is false where nothing was measured.
+struct MemoryUsage
+{
+    bool valid = false;
+    uint64_t allocations = 0; // heap allocations (summed)
+    uint64_t heapPeak = 0;    // most heap bytes live at once above the level at the start (max)
+    uint64_t stackPeak = 0;   // deepest stack use below the caller, calling thread only (max)
+    uint64_t rssPeak = 0;     // resident set high-water mark above the level at the start (max)
+
+    MemoryUsage &operator+=(const MemoryUsage &other);
+};
+
+// Process-wide counts kept by the replaced operator new / delete since the program started.
+struct HeapCounters
+{
+    uint64_t allocations = 0;
+    uint64_t bytes = 0; // requested by all of them
+    uint64_t live = 0;  // allocated and not yet freed
+    uint64_t peak = 0;  // most live at once since the last resetHeapPeak()
+};
+
+HeapCounters heapCounters();
+void resetHeapPeak();
+
+// Counting is off until this (or MemoryMeter::start) turns it on. Off, an allocation pays one relaxed
+// load and its size header (16 bytes, or the alignment asked for); on, four relaxed atomic updates on shared lines as well.
+void setHeapCounting(bool on);
+
+// Resident set size now, and its high-water mark (0 if unknown). resetResidentPeak() lowers the mark
+// to the current size (Linux 4.0+, /proc/self/clear_refs) and returns false where it can't.
+size_t residentBytes();
+size_t residentPeakBytes();
+bool resetResidentPeak();
+
+// Minor page faults the process has taken so far -- first touches of fresh pages among them; 0 where
+// getrusage doesn't count them.
+uint64_t minorPageFaults();
+
+class MemoryMeter
+{
+  public:
+    MemoryMeter();
+
+    // True if the resident set mark can be reset; otherwise RSS growth only shows when a region sets
+    // a new high for the process, and 'status' says so.
+    bool resetsResidentPeak() const { return resetsPeak_; }
+    const std::string &status() const { return status_; }
+
+    // Not inlined: start() and stop() must put their frames at the same depth for the stack probe.
+    void start();
+    MemoryUsage stop(); // usage since start()
+
+  private:
+    bool resetsPeak_ = false;
+    std::string status_;
+    uint64_t allocations_ = 0;
+    uint64_t live_ = 0;
+    size_t resident_ = 0;
+};
@@ -0,0 +1,41 @@
+#pragma once
+
+// Minimal fork-join helpers for the benchmark's setup work (input generation and copies): one
+// contiguous range per hardware thread, the first on the calling thread.
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+// Runs 'body(begin, end)' over [0, count) split into at most one range per hardware thread, each at
+// least 'grain' long.
+template <typename F>
+void parallelFor(size_t count, size_t grain, F body)
+{
+    size_t threads = std::max(1u, std::thread::hardware_concurrency());
+    threads = std::min(threads, std::max<size_t>(1, count / std::max<size_t>(1, grain)));
+    if (threads <= 1)
+    {
+        body(size_t(0), count);
+        return;
+    }
+
+    std::vector<std::thread> pool;
+    pool.reserve(threads - 1);
+    for (size_t t = 1; t < threads; ++t)
+        pool.emplace_back([=, &body] { body(count * t / threads, count * (t + 1) / threads); });
+    body(size_t(0), count / threads);
+    for (std::thread &th : pool)
+        th.join();
+}
+
+// memcpy, split across threads once there is enough of it to pay for them
+inline void parallelCopy(void *dst, const void *src, size_t bytes)
+{
+    static constexpr size_t kGrain = 1u << 20;
+    parallelFor(bytes, kGrain, [=](size_t begin, size_t end) {
+        std::memcpy(static_cast<char *>(dst) + begin, static_cast<const char *>(src) + begin, end - begin);
+    });
+}
@@ -0,0 +1,204 @@
+// perf_counters.cpp
+// Hardware performance counters via perf_event_open (Linux only; elsewhere nothing opens).
+
+#include "perf_counters.h"
+
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+static const char *kEventNames[kPerfEventCount] = {"cycles",           "instructions",      "LLC-misses",
+                                                   "dTLB-load-misses", "dTLB-store-misses", "branch-misses",
+                                                   "stall-cycles"};
+
+// group of each event: cycles, instructions, LLC and branch misses; then the dTLB misses and stalls
+static const int kEventGroup[kPerfEventCount] = {0, 0, 0, 1, 1, 0, 1};
+
+PerfCounts &PerfCounts::operator+=(const PerfCounts &other)
+{
+    for (int e = 0; e < kPerfEventCount; ++e)
+    {
+        valid[e] = valid[e] || other.valid[e];
+        value[e] += other.value[e];
+    }
+    return *this;
+}
+
+const char *PerfCounters::name(int event)
+{
+    return kEventNames[event];
+}
+
+bool PerfCounters::available() const
+{
+    for (int leader : leaders_)
+    {
+        if (leader >= 0)
+            return true;
+    }
+    return false;
+}
+
+#if defined(__linux__)
+
+// fill in perf_event_attr type/config for each PerfEvent
+static void describe(int event, perf_event_attr &attr)
+{
+    __u32 &type = attr.type;
+    __u64 &config = attr.config;
+    auto cache = [](uint64_t id, uint64_t op) {
+        return id | (op << 8) | (uint64_t(PERF_COUNT_HW_CACHE_RESULT_MISS) << 16);
+    };
+
+    type = PERF_TYPE_HARDWARE;
+    switch (event)
+    {
+    case kPerfCycles:
+        config = PERF_COUNT_HW_CPU_CYCLES;
+        break;
+    case kPerfInstructions:
+        config = PERF_COUNT_HW_INSTRUCTIONS;
+        break;
+    case kPerfLlcMisses:
+        config = PERF_COUNT_HW_CACHE_MISSES;
+        break;
+    case kPerfDtlbLoadMisses:
+        type = PERF_TYPE_HW_CACHE;
+        config = cache(PERF_COUNT_HW_CACHE_DTLB, PERF_COUNT_HW_CACHE_OP_READ);
+        break;
+    case kPerfDtlbStoreMisses:
+        type = PERF_TYPE_HW_CACHE;
+        config = cache(PERF_COUNT_HW_CACHE_DTLB, PERF_COUNT_HW_CACHE_OP_WRITE);
+        break;
+    case kPerfBranchMisses:
+        config = PERF_COUNT_HW_BRANCH_MISSES;
+        break;
+    default:
+        config = PERF_COUNT_HW_STALLED_CYCLES_BACKEND;
+        break;
+    }
+}
+
+PerfCounters::PerfCounters()
+{
+    int firstError = 0;
+    for (int e = 0; e < kPerfEventCount; ++e)
+    {
+        perf_event_attr attr;
+        std::memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        describe(e, attr);
+        int &leader = leaders_[kEventGroup[e]];
+        attr.disabled = leader < 0; // each leader gates its whole group
+        attr.exclude_kernel = 1;     // user-space only: allowed at perf_event_paranoid <= 2
+        attr.exclude_hv = 1;
+        attr.inherit = 1; // include worker threads of parallel engines
+        attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+        fds_[e] = int(syscall(SYS_perf_event_open, &attr, 0, -1, leader, 0));
+        if (fds_[e] < 0 && !firstError)
+            firstError = errno;
+        if (fds_[e] >= 0 && leader < 0)
+            leader = fds_[e];
+    }
+
+    if (!available())
+    {
+        status_ = std::string("perf_event_open failed: ") + std::strerror(firstError);
+        int paranoid;
+        if (std::ifstream("/proc/sys/kernel/perf_event_paranoid") >> paranoid)
+            status_ += " (perf_event_paranoid=" + std::to_string(paranoid) + ")";
+    }
+    else if (firstError)
+        status_ = std::string("some counters unavailable: ") + std::strerror(firstError);
+}
+
+PerfCounters::~PerfCounters()
+{
+    for (int fd : fds_)
+    {
+        if (fd >= 0)
+            close(fd);
+    }
+}
+
+void PerfCounters::start()
+{
+    for (int leader : leaders_)
+    {
+        if (leader < 0)
+            continue;
+        ioctl(leader, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+        ioctl(leader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+    }
+}
+
+PerfCounts PerfCounters::stop()
+{
+    PerfCounts counts;
+    for (int leader : leaders_)
+    {
+        if (leader >= 0)
+            ioctl(leader, PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+    }
+
+    for (int e = 0; e < kPerfEventCount; ++e)
+    {
+        uint64_t data[3]; // value, time enabled, time running
+        if (fds_[e] < 0 || read(fds_[e], data, sizeof(data)) != ssize_t(sizeof(data)))
+            continue;
+        int group = kEventGroup[e];
+        if (data[2] == 0)
+        {
+            // enabled but never on the PMU: the group needs more counters than the core has free
+            if (data[1] > 0 && fds_[e] == leaders_[group] && !warned_[group])
+            {
+                warned_[group] = true;
+                std::fprintf(stderr, "warning: counter group %d (", group);
+                const char *separator = "";
+                for (int g = 0; g < kPerfEventCount; ++g)
+                {
+                    if (kEventGroup[g] == group && fds_[g] >= 0)
+                    {
+                        std::fprintf(stderr, "%s%s", separator, kEventNames[g]);
+                        separator = ", ";
+                    }
+                }
+                std::fprintf(stderr, ") not schedulable: never ran on the PMU\n");
+            }
+            continue;
+        }
+        counts.valid[e] = true;
+        counts.value[e] = double(data[0]) * double(data[1]) / double(data[2]);
+    }
+    return counts;
+}
+
+#else
+
+PerfCounters::PerfCounters() : status_("hardware counters need Linux perf_event_open")
+{
+    for (int &fd : fds_)
+        fd = -1;
+}
+
+PerfCounters::~PerfCounters() = default;
+
+void PerfCounters::start()
+{
+}
+
+PerfCounts PerfCounters::stop()
+{
+    return PerfCounts();
+}
+
+#endif
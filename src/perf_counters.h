@@ -0,0 +1,61 @@
+#pragma once
+
+// Hardware performance counters around a timed region (Linux perf_event_open). Every counter is
+// optional: whatever the kernel, the container or the CPU refuses is simply reported as missing.
+
+#include <cstdint>
+#include <string>
+
+enum PerfEvent
+{
+    kPerfCycles,
+    kPerfInstructions,
+    kPerfLlcMisses,
+    kPerfDtlbLoadMisses,
+    kPerfDtlbStoreMisses,
+    kPerfBranchMisses,
+    kPerfStallCycles, // backend stall cycles
+    kPerfEventCount,
+};
+
+// The events open in groups a core can count at once: cycles and instructions take fixed counters
+// on most x86 parts, so each group asks for at most three general-purpose ones.
+static constexpr int kPerfGroupCount = 2;
+
+// Counter values over one or more regions; valid[e] is false for counters that could not be opened.
+struct PerfCounts
+{
+    bool valid[kPerfEventCount] = {};
+    double value[kPerfEventCount] = {};
+
+    PerfCounts &operator+=(const PerfCounts &other);
+};
+
+class PerfCounters
+{
+  public:
+    // Opens every counter it can, in kPerfGroupCount groups, on the calling thread (and threads it
+    // creates later).
+    PerfCounters();
+    ~PerfCounters();
+
+    PerfCounters(const PerfCounters &) = delete;
+    PerfCounters &operator=(const PerfCounters &) = delete;
+
+    // True if at least one counter opened; otherwise 'status' says why not.
+    bool available() const;
+    const std::string &status() const { return status_; }
+
+    void start();
+    // Values since start(), scaled up if the kernel multiplexed the groups. A group the kernel never
+    // scheduled reads as missing, with a warning on stderr the first time.
+    PerfCounts stop();
+
+    static const char *name(int event);
+
+  private:
+    int fds_[kPerfEventCount];
+    int leaders_[kPerfGroupCount] = {-1, -1};
+    bool warned_[kPerfGroupCount] = {};
+    std::string status_;
+};
@@ -0,0 +1,62 @@
+#pragma once
+
+// Philox4x32-10 (Salmon et al., "Parallel Random Numbers: As Easy as 1, 2, 3", SC11): a
+// counter-based generator, so any element of any stream can be drawn directly, in any order, on any
+// thread. Satisfies UniformRandomBitGenerator, so it plugs into the <random> distributions.
+
+#include <cstdint>
+
+class Philox
+{
+  public:
+    using result_type = uint32_t;
+
+    // The generator for word sequence ('stream', 'index') under 'seed'. Sequences with different
+    // (stream, index) never overlap.
+    Philox(uint64_t seed, uint32_t stream, uint32_t index)
+        : key_{uint32_t(seed), uint32_t(seed >> 32)}, counter_{0, index, stream, 0}
+    {
+    }
+
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return UINT32_MAX; }
+
+    result_type operator()()
+    {
+        if (used_ == 4)
+        {
+            block();
+            used_ = 0;
+        }
+        return out_[used_++];
+    }
+
+  private:
+    // encrypt the counter into the next four output words, then advance it
+    void block()
+    {
+        uint32_t c[4] = {counter_[0], counter_[1], counter_[2], counter_[3]};
+        uint32_t k0 = key_[0], k1 = key_[1];
+        for (int round = 0; round < 10; ++round)
+        {
+            uint64_t p0 = uint64_t(0xD2511F53u) * c[0];
+            uint64_t p1 = uint64_t(0xCD9E8D57u) * c[2];
+            uint32_t n0 = uint32_t(p1 >> 32) ^ c[1] ^ k0;
+            uint32_t n2 = uint32_t(p0 >> 32) ^ c[3] ^ k1;
+            c[0] = n0;
+            c[1] = uint32_t(p1);
+            c[2] = n2;
+            c[3] = uint32_t(p0);
+            k0 += 0x9E3779B9u;
+            k1 += 0xBB67AE85u;
+        }
+        for (int i = 0; i < 4; ++i)
+            out_[i] = c[i];
+        ++counter_[0];
+    }
+
+    uint32_t key_[2];
+    uint32_t counter_[4];
+    uint32_t out_[4] = {};
+    int used_ = 4;
+};
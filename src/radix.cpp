@@ -6,165 +6,558 @@
 //
 
 #include "radix.h"
+#include "radix_kernels.h"
+#include "radix_telemetry.h"
+#include "radix_timeline.h"
+#include "radix_trace.h"
+#include "radix_tuning.h"
 
-#ifndef PREFETCH
-#define PREFETCH 0
-#endif
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
 
-#if PREFETCH
+// ================================================================================================
+// Settings for one call: RadixOptions with every unset tunable filled in from the tuning profile
+// ================================================================================================
+struct RadixPlan {
+  RadixPrefetch prefetch;
+  uint32_t digitBits;
+  uint32_t smallSortThreshold;
+  uint32_t threads;
+  bool resultInPlace;
+  bool streamFinalPass;
+};
 
-#define pfval 64
-#define pfval2 128
+static RadixPlan ResolvePlan(const RadixOptions &options, uint32_t elements,
+                             const RadixTuning &tuning = RadixGetTuning()) {
+  const RadixTuningEntry &entry = RadixLookupTuning(tuning, elements);
 
-// x86/x64 with SSE support
-#if defined(__SSE__) || defined(_M_IX86) || defined(_M_X64)
-#include <xmmintrin.h>
-#define pf(x) \
-  _mm_prefetch(reinterpret_cast<const char *>((x) + i + pfval), _MM_HINT_T0)
-#define pf2(x) \
-  _mm_prefetch(reinterpret_cast<const char *>((x) + i + pfval2), _MM_HINT_T0)
+  RadixPlan plan;
+  plan.prefetch = options.prefetch.value_or(entry.prefetch);
+  plan.digitBits = options.digitBits.value_or(entry.digitBits);
+  plan.smallSortThreshold =
+      options.smallSortThreshold.value_or(tuning.smallSortThreshold);
+  plan.threads = options.threads.value_or(entry.threads);
+  plan.resultInPlace = options.resultInPlace;
+  plan.streamFinalPass = options.streamFinalPass;
+  return plan;
+}
 
-// MSVC on ARM64
-#elif defined(_M_ARM64)
-#include <arm64intrin.h>  // ARM64 intrinsics for MSVC
-#define pf(x) __prefetch((x) + i + pfval)
-#define pf2(x) __prefetch((x) + i + pfval2)
+// RadixSort11 keeps the compiled defaults whatever profile is active: it is the
+// baseline the tuned engines are measured against.
+static RadixPlan DefaultPlan(uint32_t elements) {
+  static const RadixTuning defaults = RadixDefaultTuning();
+  return ResolvePlan(RadixOptions(), elements, defaults);
+}
 
-// GCC or Clang on any platform with builtin prefetch (e.g., Linux/ARM,
-// macOS/ARM)
-#elif defined(__GNUC__) || defined(__clang__)
-#define pf(x) __builtin_prefetch((x) + i + pfval, 0, 3)
-#define pf2(x) __builtin_prefetch((x) + i + pfval2, 0, 3)
+// ================================================================================================
+// phase timer for RadixPassStats: Lap() charges the time since the previous lap to a phase (0:
+// histogram, 1: prefix sum, 2 + p: scatter pass p). Compiles to nothing without RADIX_STATS.
+// ================================================================================================
+#if defined(RADIX_STATS) && RADIX_STATS
+class PhaseTimer {
+ public:
+  explicit PhaseTimer(RadixPassStats *stats)
+      : stats_(stats), last_(stats ? Now() : 0) {}
 
-// Not supported  fallback
-#else
-#pragma message( \
-    "Prefetch requested but not supported on this platform  disabling.")
-#undef PREFETCH
-#define PREFETCH 0
-#define pf(x)
-#define pf2(x)
-#endif
+  void Lap(uint32_t phase) {
+    if (!stats_) return;
+    uint64_t now = Now();
+    uint64_t ns = now - last_;
+    last_ = now;
+    if (phase == 0) {
+      stats_->histogramNs += ns;
+    } else if (phase == 1) {
+      stats_->prefixSumNs += ns;
+    } else if (phase - 2 < 3) {
+      stats_->scatterNs[phase - 2] += ns;
+    }
+  }
+
+ private:
+  static uint64_t Now() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+  }
 
+  RadixPassStats *stats_;
+  uint64_t last_;
+};
 #else
-// Prefetch disabled
-#define pf(x)
-#define pf2(x)
+class PhaseTimer {
+ public:
+  explicit PhaseTimer(RadixPassStats *) {}
+  void Lap(uint32_t) {}
+};
 #endif
 
 // ================================================================================================
-// flip a float for sorting
-//  finds SIGN of fp number.
-//  if it's 1 (negative float), it flips all bits
-//  if it's 0 (positive float), it flips the sign only
+// small inputs: insertion sort on the flipped keys (same order as the radix passes, and no
+// histograms to clear), in place
 // ================================================================================================
-inline uint32_t FloatFlip(uint32_t f) {
-  uint32_t mask = -int32_t(f >> 31) | 0x80000000;
-  return f ^ mask;
-}
+template <typename Traits>
+void InsertionSort(typename Traits::Key *array, uint32_t elements) {
+  using Key = typename Traits::Key;
 
-inline void FloatFlipX(uint32_t &f) {
-  uint32_t mask = -int32_t(f >> 31) | 0x80000000;
-  f ^= mask;
+  for (uint32_t i = 1; i < elements; i++) {
+    Key ai = array[i];
+    Key fi = Traits::Encode(ai);
+    uint32_t j = i;
+    for (; j > 0 && Traits::Encode(array[j - 1]) > fi; j--) {
+      array[j] = array[j - 1];
+    }
+    array[j] = ai;
+  }
 }
 
 // ================================================================================================
-// flip a float back (invert FloatFlip)
-//  signed was flipped from above, so:
-//  if sign is 1 (negative), it flips the sign bit back
-//  if sign is 0 (positive), it flips all bits back
+// Main radix sort: kBits-wide digits, LSD first, ping-ponging between 'array' and 'sort'.
+// Returns the buffer holding the result ('sort' for an odd pass count, 'array' for an even one).
 // ================================================================================================
-inline uint32_t IFloatFlip(uint32_t f) {
-  uint32_t mask = ((f >> 31) - 1) | 0x80000000;
-  return f ^ mask;
-}
+template <typename Traits, uint32_t kBits>
+typename Traits::Key *RadixSortImpl(typename Traits::Key *array,
+                                    typename Traits::Key *sort,
+                                    uint32_t elements, const RadixPlan &plan,
+                                    RadixPassStats *stats = nullptr) {
+  using Key = typename Traits::Key;
+  constexpr uint32_t kPasses = (sizeof(Key) * 8 + kBits - 1) / kBits;
+  constexpr uint32_t kHist = 1u << kBits;
+  constexpr uint32_t kMask = kHist - 1;
+  uint32_t i, p;
+  PhaseTimer timer(stats);
 
-// ---- utils for accessing 11-bit quantities
-#define _0(x) (x & 0x7FF)
-#define _1(x) (x >> 11 & 0x7FF)
-#define _2(x) (x >> 22)
+  // kPasses histograms on the stack (on the heap for 16-bit digits):
+  constexpr bool kOnStack = kHist * kPasses <= 16384;
+  uint32_t stack[kOnStack ? kHist * kPasses : 1];
+  std::unique_ptr<uint32_t[]> heap(kOnStack ? nullptr
+                                            : new uint32_t[kHist * kPasses]);
+  uint32_t *b0 = kOnStack ? stack : heap.get();
+
+  for (i = 0; i < kHist * kPasses; i++) {
+    b0[i] = 0;
+  }
+
+  // 1.  parallel histogramming pass
+  //
+  const RadixPrefetch &pf = plan.prefetch;
+  HistogramPass<Traits, kBits>(array, b0, elements, pf);
+  timer.Lap(0);
+
+  // 2.  Sum the histograms -- each histogram entry records the number of values
+  // preceding itself.
+  PrefixSum<kHist, kPasses>(b0);
+  timer.Lap(1);
+
+  // 3.  digit 0: flip entire value, write out flipped  array -> sort
+  //     middle digits: copy, swapping buffers each pass
+  //     last digit: flip back on the way out (streamed, if asked for and the
+  //     output is large enough to outnumber the line buffers)
+  ScatterPass<Traits, kMask, true, kPasses == 1>(array, sort, b0, 0, elements,
+                                                 pf);
+  timer.Lap(2);
+
+  Key *src = sort;
+  Key *dst = array;
+  for (p = 1; p < kPasses; p++) {
+    if (p + 1 < kPasses) {
+      ScatterPass<Traits, kMask, false, false>(src, dst, b0 + p * kHist,
+                                               p * kBits, elements, pf);
+    } else {
+      // compiled out for 16-bit digits, whose line buffers would be 4 MB
+      bool streamed = false;
+      if constexpr (kBits <= 11) {
+        streamed = plan.streamFinalPass &&
+                   elements >= kHist * (64 / sizeof(Key));
+        if (streamed) {
+          StreamScatterPass<Traits, kMask, true>(src, dst, b0 + p * kHist,
+                                                 p * kBits, elements, pf);
+        }
+      }
+      if (!streamed) {
+        ScatterPass<Traits, kMask, false, true>(src, dst, b0 + p * kHist,
+                                                p * kBits, elements, pf);
+      }
+    }
+    timer.Lap(2 + p);
+    Key *t = src;
+    src = dst;
+    dst = t;
+  }
+
+  return src;
+}
 
 // ================================================================================================
-// Main radix sort
+// barrier between the phases of the parallel sort
 // ================================================================================================
-void RadixSort11(float *farray, float *sorted, uint32_t elements) {
-  uint32_t i;
-  uint32_t *sort = (uint32_t *)sorted;
-  uint32_t *array = (uint32_t *)farray;
+class PassBarrier {
+ public:
+  explicit PassBarrier(uint32_t count) : count_(count) {}
 
-  // 3 histograms on the stack:
-  const uint32_t kHist = 2048;
-  uint32_t b0[kHist * 3];
+  void Wait() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    uint32_t generation = generation_;
+    if (++waiting_ == count_) {
+      waiting_ = 0;
+      generation_++;
+      cv_.notify_all();
+    } else {
+      cv_.wait(lock, [&] { return generation != generation_; });
+    }
+  }
 
-  uint32_t *b1 = b0 + kHist;
-  uint32_t *b2 = b1 + kHist;
+ private:
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  uint32_t count_;
+  uint32_t waiting_ = 0;
+  uint32_t generation_ = 0;
+};
 
-  for (i = 0; i < kHist * 3; i++) {
-    b0[i] = 0;
+// ================================================================================================
+// one worker's phases for the timeline (radix_timeline.h); does nothing unless it was on at the
+// start of the call. Each Next ends the current phase and starts another at the same instant.
+// Constructed on the thread whose phases it records.
+// ================================================================================================
+class PhaseRecorder {
+ public:
+  PhaseRecorder(bool on, uint32_t call, uint32_t elements, uint32_t worker)
+      : on_(on) {
+    event_.call = call;
+    event_.elements = elements;
+    event_.worker = uint16_t(worker);
+    if (on) event_.thread = RadixTimelineThreadId();
   }
-  // memset(b0, 0, kHist * 12);
 
-  // 1.  parallel histogramming pass
-  //
-  for (i = 0; i < elements; i++) {
-    pf(array);
+  // a phase that began before this thread ran (a worker's start-up)
+  void Since(RadixPhase phase, uint64_t beginNs) {
+    if (!on_) return;
+    event_.phase = phase;
+    event_.pass = 0;
+    event_.beginNs = beginNs;
+    active_ = true;
+  }
 
-    uint32_t fi = FloatFlip((uint32_t &)array[i]);
+  void Next(RadixPhase phase, uint32_t pass) {
+    if (!on_) return;
+    uint64_t now = RadixTimelineNow();
+    if (active_) {
+      event_.endNs = now;
+      RadixTimelineRecord(event_);
+    }
+    event_.phase = phase;
+    event_.pass = uint8_t(pass);
+    event_.beginNs = now;
+    active_ = true;
+  }
 
-    b0[_0(fi)]++;
-    b1[_1(fi)]++;
-    b2[_2(fi)]++;
+  void End() {
+    if (!on_ || !active_) return;
+    event_.endNs = RadixTimelineNow();
+    RadixTimelineRecord(event_);
+    active_ = false;
   }
 
-  // 2.  Sum the histograms -- each histogram entry records the number of values
-  // preceding itself.
-  {
-    uint32_t sum0 = 0, sum1 = 0, sum2 = 0;
-    uint32_t tsum;
-    for (i = 0; i < kHist; i++) {
-      tsum = b0[i] + sum0;
-      b0[i] = sum0 - 1;
-      sum0 = tsum;
-
-      tsum = b1[i] + sum1;
-      b1[i] = sum1 - 1;
-      sum1 = tsum;
-
-      tsum = b2[i] + sum2;
-      b2[i] = sum2 - 1;
-      sum2 = tsum;
+ private:
+  RadixPhaseEvent event_;
+  bool on_;
+  bool active_ = false;
+};
+
+// ================================================================================================
+// Parallel radix sort: the same passes, each split across 'threads' contiguous chunks. Per pass,
+// every thread histograms its chunk of the current source; after a barrier each thread derives
+// its own bucket offsets (keys in lower buckets, plus keys in the same bucket from lower chunks),
+// which keeps the scatter stable, and scatters its chunk. Counts are double-buffered so one
+// barrier per phase is enough.
+// ================================================================================================
+template <typename Traits, uint32_t kBits>
+typename Traits::Key *RadixSortParallel(typename Traits::Key *array,
+                                        typename Traits::Key *sort,
+                                        uint32_t elements, uint32_t threads,
+                                        const RadixPlan &plan) {
+  using Key = typename Traits::Key;
+  constexpr uint32_t kPasses = (sizeof(Key) * 8 + kBits - 1) / kBits;
+  constexpr uint32_t kHist = 1u << kBits;
+  constexpr uint32_t kMask = kHist - 1;
+
+  std::unique_ptr<uint32_t[]> counts(new uint32_t[2 * threads * kHist]);
+  PassBarrier barrier(threads);
+  Key *buffers[2] = {array, sort};
+
+  const bool timeline = RadixTimelineEnabled();
+  const uint32_t call = timeline ? RadixTimelineNextCall() : 0;
+  const uint64_t callBegin = timeline ? RadixTimelineNow() : 0;
+
+  auto worker = [&](uint32_t t) {
+    const uint32_t lo = uint32_t(uint64_t(elements) * t / threads);
+    const uint32_t hi = uint32_t(uint64_t(elements) * (t + 1) / threads);
+    PhaseRecorder phases(timeline, call, elements, t);
+    if (t > 0) phases.Since(RadixPhase::Idle, callBegin);
+    std::unique_ptr<uint32_t[]> b(new uint32_t[kHist]);
+
+    for (uint32_t p = 0; p < kPasses; p++) {
+      const Key *src = buffers[p & 1];
+      Key *dst = buffers[(p + 1) & 1];
+      const uint32_t shift = p * kBits;
+      uint32_t *passCounts = counts.get() + (p & 1) * threads * kHist;
+      uint32_t *cnt = passCounts + t * kHist;
+
+      // 1.  histogram this chunk
+      phases.Next(RadixPhase::Histogram, p);
+      for (uint32_t d = 0; d < kHist; d++) {
+        cnt[d] = 0;
+      }
+      for (uint32_t i = lo; i < hi; i++) {
+        Key si = p == 0 ? Traits::Encode(src[i]) : src[i];
+        cnt[uint32_t(si >> shift) & kMask]++;
+      }
+      phases.Next(RadixPhase::Idle, p);
+      barrier.Wait();
+
+      // 2.  offsets for this chunk
+      phases.Next(RadixPhase::PrefixSum, p);
+      uint32_t sum = 0;
+      for (uint32_t d = 0; d < kHist; d++) {
+        uint32_t before = 0, total = 0;
+        for (uint32_t u = 0; u < threads; u++) {
+          uint32_t c = passCounts[u * kHist + d];
+          before += u < t ? c : 0;
+          total += c;
+        }
+        b[d] = sum + before - 1;
+        sum += total;
+      }
+
+      // 3.  scatter this chunk
+      phases.Next(RadixPhase::Scatter, p);
+      if (p == 0) {
+        ScatterPass<Traits, kMask, true, kPasses == 1>(
+            src + lo, dst, b.get(), shift, hi - lo, plan.prefetch);
+      } else if (p + 1 < kPasses) {
+        ScatterPass<Traits, kMask, false, false>(src + lo, dst, b.get(), shift,
+                                                 hi - lo, plan.prefetch);
+      } else {
+        ScatterPass<Traits, kMask, false, true>(src + lo, dst, b.get(), shift,
+                                                hi - lo, plan.prefetch);
+      }
+      phases.Next(RadixPhase::Idle, p);
+      barrier.Wait();
     }
+    phases.End();
+  };
+
+  std::vector<std::thread> pool;
+  for (uint32_t t = 1; t < threads; t++) {
+    pool.emplace_back(worker, t);
+  }
+  worker(0);
+  PhaseRecorder joining(timeline, call, elements, 0);
+  joining.Next(RadixPhase::Idle, 0);
+  for (std::thread &th : pool) {
+    th.join();
   }
+  joining.End();
+  PhaseRecorder whole(timeline, call, elements, 0);
+  whole.Since(RadixPhase::Sort, callBegin);
+  whole.End();
 
-  // byte 0: floatflip entire value, read/write histogram, write out flipped
-  for (i = 0; i < elements; i++) {
-    uint32_t fi = array[i];
-    FloatFlipX(fi);
-    uint32_t pos = _0(fi);
+  return buffers[kPasses & 1];
+}
+
+// ================================================================================================
+// one digit width: serial or parallel (each thread needs at least a histogram's worth of keys)
+// ================================================================================================
+template <typename Traits, uint32_t kBits>
+typename Traits::Key *RadixSortBits(typename Traits::Key *array,
+                                    typename Traits::Key *sort,
+                                    uint32_t elements, const RadixPlan &plan,
+                                    RadixPath &path) {
+  uint32_t threads = plan.threads;
+  if (threads > elements >> kBits) threads = elements >> kBits;
+
+  if (threads > 1) {
+    path = kRadixPathParallel;
+    return RadixSortParallel<Traits, kBits>(array, sort, elements, threads,
+                                            plan);
+  }
+  path = kBits == 8 ? kRadixPath8 : kBits == 16 ? kRadixPath16 : kRadixPath11;
+  return RadixSortImpl<Traits, kBits>(array, sort, elements, plan);
+}
+
+// ================================================================================================
+// Pass planning: tiny inputs go to insertion sort; otherwise the planned digit width (8, 11 or 16
+// bits). When the caller wants the result in its own array and the width would give an odd pass
+// count (11-bit digits on 32-bit keys), switch to 8-bit digits so the last scatter writes into
+// 'array' instead of paying for a copy back. 'path' gets the choice, for telemetry.
+// ================================================================================================
+template <typename Traits>
+typename Traits::Key *RadixSortPlanned(typename Traits::Key *array,
+                                       typename Traits::Key *sort,
+                                       uint32_t elements,
+                                       const RadixOptions &options,
+                                       RadixPath &path) {
+  constexpr uint32_t kKeyBits = sizeof(typename Traits::Key) * 8;
+  const RadixPlan plan = ResolvePlan(options, elements);
+
+  if (elements < plan.smallSortThreshold) {
+    path = kRadixPathInsertion;
+    InsertionSort<Traits>(array, elements);
+    return array;
+  }
+
+  uint32_t bits = plan.digitBits;
+  if (bits != 8 && bits != 16) bits = 11;
+  if (plan.resultInPlace && ((kKeyBits + bits - 1) / bits & 1)) bits = 8;
+
+  switch (bits) {
+    case 8:
+      return RadixSortBits<Traits, 8>(array, sort, elements, plan, path);
+    case 16:
+      return RadixSortBits<Traits, 16>(array, sort, elements, plan, path);
+    default:
+      return RadixSortBits<Traits, 11>(array, sort, elements, plan, path);
+  }
+}
+
+// ================================================================================================
+// Call hooks. Tracing (radix_trace.h) samples how presorted the keys are, from up to 64 evenly
+// spaced neighbour pairs, then times the call; telemetry (radix_telemetry.h) adds it to the thread's
+// counters. With both off a call pays two relaxed loads.
+// ================================================================================================
+template <typename Traits>
+uint8_t SampleAscending(const typename Traits::Key *array, uint32_t elements) {
+  if (elements < 2) return 255;
 
-    pf2(array);
-    sort[++b0[pos]] = fi;
+  uint32_t pairs = elements - 1 < 64 ? elements - 1 : 64;
+  uint32_t ascending = 0;
+  for (uint32_t s = 0; s < pairs; s++) {
+    uint32_t i = uint32_t(uint64_t(elements - 1) * s / pairs);
+    ascending += Traits::Encode(array[i]) <= Traits::Encode(array[i + 1]);
   }
+  return uint8_t((ascending * 255 + pairs / 2) / pairs);
+}
+
+template <typename Traits, typename Sort>
+typename Traits::Key *RadixSortHooked(typename Traits::Key *array,
+                                      uint32_t elements, RadixTraceKey key,
+                                      const RadixOptions &options, Sort sort) {
+  using Key = typename Traits::Key;
+  RadixPath path = kRadixPath11;
+  const bool traced = RadixTraceEnabled();
+  RadixTelemetrySlot *slot =
+      RadixTelemetryEnabled() ? RadixTelemetryThreadSlot() : nullptr;
+  if (!traced && !slot) return sort(path);
 
-  // byte 1: read/write histogram, copy
-  //   sorted -> array
-  for (i = 0; i < elements; i++) {
-    uint32_t si = sort[i];
-    uint32_t pos = _1(si);
-    pf2(sort);
-    array[++b1[pos]] = si;
+  RadixTraceRecord record;
+  if (traced) {
+    uint32_t threads = ResolvePlan(options, elements).threads;
+    record.elements = elements;
+    record.keyType = uint8_t(key);
+    record.ascending = SampleAscending<Traits>(array, elements);
+    record.threads = uint8_t(threads < 255 ? threads : 255);
+    record.flags = (options.resultInPlace ? kRadixTraceInPlace : 0) |
+                   (options.streamFinalPass ? kRadixTraceStream : 0);
+    record.startNs = RadixTraceNow();
   }
+  uint64_t weight = slot ? RadixTelemetryWeight(slot, elements) : 0;
+  uint64_t ticks = weight ? RadixTelemetryTicks() : 0;
 
-  // byte 2: read/write histogram, copy & flip out
-  //   array -> sorted
-  for (i = 0; i < elements; i++) {
-    uint32_t ai = array[i];
-    uint32_t pos = _2(ai);
+  Key *out = sort(path);
 
-    pf2(array);
-    sort[++b2[pos]] = IFloatFlip(ai);
+  if (slot) {
+    if (weight) ticks = (RadixTelemetryTicks() - ticks) * weight;
+    RadixTelemetryCount(slot, elements, sizeof(Key), path, ticks);
   }
+  if (traced) {
+    record.durationNs = RadixTraceNow() - record.startNs;
+    RadixTraceAppend(record);
+  }
+  return out;
+}
 
-  // to write original:
-  // memcpy(array, sorted, elements * 4);
-}
\ No newline at end of file
+template <typename Traits>
+typename Traits::Key *RadixSortEntry(typename Traits::Key *array,
+                                     typename Traits::Key *sort,
+                                     uint32_t elements, RadixTraceKey key,
+                                     const RadixOptions &options) {
+  return RadixSortHooked<Traits>(
+      array, elements, key, options, [&](RadixPath &path) {
+        return RadixSortPlanned<Traits>(array, sort, elements, options, path);
+      });
+}
+
+// ================================================================================================
+// Public entry points
+// ================================================================================================
+void RadixSort11(float *farray, float *sorted, uint32_t elements) {
+  const RadixOptions options;
+  RadixSortHooked<FloatKeys>(
+      (uint32_t *)farray, elements, RadixTraceKey::F32, options,
+      [&](RadixPath &path) {
+        path = kRadixPath11;
+        return RadixSortImpl<FloatKeys, 11>((uint32_t *)farray,
+                                            (uint32_t *)sorted, elements,
+                                            DefaultPlan(elements));
+      });
+
+  // to get the result in 'farray' without a memcpy back, use RadixSortKeys
+  // with RadixOptions::resultInPlace.
+}
+
+void RadixSort11(float *farray, float *sorted, uint32_t elements,
+                 RadixPassStats *stats) {
+  const RadixOptions options;
+  RadixSortHooked<FloatKeys>(
+      (uint32_t *)farray, elements, RadixTraceKey::F32, options,
+      [&](RadixPath &path) {
+        path = kRadixPath11;
+        return RadixSortImpl<FloatKeys, 11>((uint32_t *)farray,
+                                            (uint32_t *)sorted, elements,
+                                            DefaultPlan(elements), stats);
+      });
+}
+
+float *RadixSortKeys(float *keys, float *scratch, uint32_t elements,
+                     const RadixOptions &options) {
+  return (float *)RadixSortEntry<FloatKeys>((uint32_t *)keys,
+                                           (uint32_t *)scratch, elements,
+                                           RadixTraceKey::F32, options);
+}
+
+double *RadixSortKeys(double *keys, double *scratch, uint32_t elements,
+                      const RadixOptions &options) {
+  return (double *)RadixSortEntry<DoubleKeys>((uint64_t *)keys,
+                                             (uint64_t *)scratch, elements,
+                                             RadixTraceKey::F64, options);
+}
+
+int32_t *RadixSortKeys(int32_t *keys, int32_t *scratch, uint32_t elements,
+                       const RadixOptions &options) {
+  return (int32_t *)RadixSortEntry<SignedKeys<uint32_t>>(
+      (uint32_t *)keys, (uint32_t *)scratch, elements, RadixTraceKey::I32,
+      options);
+}
+
+uint32_t *RadixSortKeys(uint32_t *keys, uint32_t *scratch, uint32_t elements,
+                        const RadixOptions &options) {
+  return RadixSortEntry<UnsignedKeys<uint32_t>>(keys, scratch, elements,
+                                                RadixTraceKey::U32, options);
+}
+
+int64_t *RadixSortKeys(int64_t *keys, int64_t *scratch, uint32_t elements,
+                       const RadixOptions &options) {
+  return (int64_t *)RadixSortEntry<SignedKeys<uint64_t>>(
+      (uint64_t *)keys, (uint64_t *)scratch, elements, RadixTraceKey::I64,
+      options);
+}
+
+uint64_t *RadixSortKeys(uint64_t *keys, uint64_t *scratch, uint32_t elements,
+                        const RadixOptions &options) {
+  return RadixSortEntry<UnsignedKeys<uint64_t>>(keys, scratch, elements,
+                                                RadixTraceKey::U64, options);
+}
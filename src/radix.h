@@ -2,4 +2,76 @@
 
 #include <stdint.h>
 
-void RadixSort11(float *farray, float *sorted, uint32_t elements);
\ No newline at end of file
+#include <optional>
+
+// Sorts 'elements' floats in three 11-bit passes. The result lands in 'sorted'; 'farray' is used as
+// the ping-pong buffer and is overwritten.
+void RadixSort11(float *farray, float *sorted, uint32_t elements);
+
+// Time spent in each phase of RadixSort11, in steady_clock nanoseconds. Calls add to the fields, so
+// one struct can collect a whole batch of sorts.
+struct RadixPassStats
+{
+    uint64_t histogramNs = 0;   // 1. histogram pass
+    uint64_t prefixSumNs = 0;   // 2. prefix sums
+    uint64_t scatterNs[3] = {}; // 3. scatter passes 0, 1 and 2
+};
+
+// RadixSort11, recording its phases into 'stats'. The timestamps are only compiled in with
+// RADIX_STATS (CMake option ENABLE_RADIX_STATS); otherwise this is plain RadixSort11 and 'stats' is
+// left untouched.
+void RadixSort11(float *farray, float *sorted, uint32_t elements, RadixPassStats *stats);
+
+// Cache level a prefetch targets (x86 naming: T0 = all levels ... NTA = non-temporal).
+enum class RadixPrefetchHint : uint8_t
+{
+    T0,
+    T1,
+    T2,
+    NTA,
+};
+
+// Software prefetch settings. Distances are in elements; 0 turns that prefetch off.
+struct RadixPrefetch
+{
+    uint32_t srcDistance = 0;
+    RadixPrefetchHint srcHint = RadixPrefetchHint::T0;
+
+    // Scatter passes: look this many keys ahead and fetch the line that key will be written to.
+    uint32_t dstDistance = 0;
+    RadixPrefetchHint dstHint = RadixPrefetchHint::T0;
+};
+
+// Per-call options for the RadixSortKeys engines.
+struct RadixOptions
+{
+    // Tunables. Whatever is left unset comes from the tuning profile entry for the call's size (see
+    // radix_tuning.h), which falls back to compiled defaults.
+    std::optional<RadixPrefetch> prefetch;      // source reads and scatter destinations
+    std::optional<uint32_t> digitBits;          // 8, 11 or 16 bits per pass
+    std::optional<uint32_t> smallSortThreshold; // insertion sort below this many elements
+    std::optional<uint32_t> threads;            // split each pass across this many threads
+
+    // Plan an even number of passes so the last scatter writes into 'keys' and the result never
+    // needs copying back out of 'scratch'. 32-bit keys switch from three 11-bit digits to four
+    // 8-bit ones; 64-bit keys already take six passes.
+    bool resultInPlace = false;
+
+    // Write the last pass through per-bucket cache-line buffers flushed with non-temporal stores, so
+    // the output does not pull every destination line into the cache (and evict the caller's data)
+    // on its way to memory. Only pays off once the output is well beyond the last-level cache. It is
+    // ignored below one cache line of keys per bucket -- 2^15 elements with 11-bit digits, 2^12 with
+    // 8-bit ones (resultInPlace), half that for 64-bit keys -- and with 16-bit digits or threads.
+    bool streamFinalPass = false;
+};
+
+// Typed engines behind the RadixSort front end (radix_sort.h). 'keys' and 'scratch' both hold
+// 'elements' entries and are used as ping-pong buffers; the return value is whichever of the two
+// holds the sorted result (odd pass counts end in 'scratch', even ones and insertion-sorted small
+// inputs in 'keys').
+float *RadixSortKeys(float *keys, float *scratch, uint32_t elements, const RadixOptions &options = {});
+double *RadixSortKeys(double *keys, double *scratch, uint32_t elements, const RadixOptions &options = {});
+int32_t *RadixSortKeys(int32_t *keys, int32_t *scratch, uint32_t elements, const RadixOptions &options = {});
+uint32_t *RadixSortKeys(uint32_t *keys, uint32_t *scratch, uint32_t elements, const RadixOptions &options = {});
+int64_t *RadixSortKeys(int64_t *keys, int64_t *scratch, uint32_t elements, const RadixOptions &options = {});
+uint64_t *RadixSortKeys(uint64_t *keys, uint64_t *scratch, uint32_t elements, const RadixOptions &options = {});
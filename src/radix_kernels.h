@@ -0,0 +1,343 @@
+// radix_kernels.h: the building blocks of the radix sorts in radix.cpp
+//
+//   Copyright (C) Herf Consulting LLC 2001.  All Rights Reserved.
+//   Use for anything you want, just tell me what you do with it.
+//   Code provided "as-is" with no liabilities for anything that goes wrong.
+//
+// Internal: included by radix.cpp and by the pass microbenchmarks (radix_micro.cpp), so both run
+// the same code.
+//
+
+#pragma once
+
+#include "radix.h"
+
+#include <memory>
+
+// non-temporal stores for the final pass
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <immintrin.h>
+#define STREAM_STORES 1
+#else
+#include <string.h>
+#define STREAM_STORES 0
+#endif
+
+// prefetch intrinsics; distances and hints are runtime settings (RadixOptions::prefetch), the
+// PREFETCH build flag only picks the default source distance
+#if defined(__GNUC__) || defined(__clang__)
+// GCC or Clang on any platform: __builtin_prefetch
+
+// x86/x64 with SSE support
+#elif defined(__SSE__) || defined(_M_IX86) || defined(_M_X64)
+#include <xmmintrin.h>
+
+// MSVC on ARM64
+#elif defined(_M_ARM64)
+#include <arm64intrin.h>  // ARM64 intrinsics for MSVC
+
+// Not supported - fallback
+#elif defined(PREFETCH) && PREFETCH
+#pragma message( \
+    "Prefetch requested but not supported on this platform - disabling.")
+#endif
+
+// ================================================================================================
+// prefetch the line holding 'p' into the level picked by 'hint'; kWrite asks for it in a writable
+// state (scatter destinations)
+// ================================================================================================
+template <bool kWrite>
+inline void Prefetch(const void *p, RadixPrefetchHint hint) {
+#if defined(__GNUC__) || defined(__clang__)
+  switch (hint) {
+    case RadixPrefetchHint::T0: __builtin_prefetch(p, kWrite, 3); break;
+    case RadixPrefetchHint::T1: __builtin_prefetch(p, kWrite, 2); break;
+    case RadixPrefetchHint::T2: __builtin_prefetch(p, kWrite, 1); break;
+    case RadixPrefetchHint::NTA: __builtin_prefetch(p, kWrite, 0); break;
+  }
+#elif defined(__SSE__) || defined(_M_IX86) || defined(_M_X64)
+  const char *c = reinterpret_cast<const char *>(p);
+  switch (hint) {
+    case RadixPrefetchHint::T0: _mm_prefetch(c, _MM_HINT_T0); break;
+    case RadixPrefetchHint::T1: _mm_prefetch(c, _MM_HINT_T1); break;
+    case RadixPrefetchHint::T2: _mm_prefetch(c, _MM_HINT_T2); break;
+    case RadixPrefetchHint::NTA: _mm_prefetch(c, _MM_HINT_NTA); break;
+  }
+#elif defined(_M_ARM64)
+  (void)hint;
+  __prefetch(p);
+#else
+  (void)p;
+  (void)hint;
+#endif
+}
+
+// ================================================================================================
+// flip a float for sorting
+//  finds SIGN of fp number.
+//  if it's 1 (negative float), it flips all bits
+//  if it's 0 (positive float), it flips the sign only
+// ================================================================================================
+inline uint32_t FloatFlip(uint32_t f) {
+  uint32_t mask = -int32_t(f >> 31) | 0x80000000;
+  return f ^ mask;
+}
+
+inline void FloatFlipX(uint32_t &f) {
+  uint32_t mask = -int32_t(f >> 31) | 0x80000000;
+  f ^= mask;
+}
+
+// ================================================================================================
+// flip a float back (invert FloatFlip)
+//  signed was flipped from above, so:
+//  if sign is 1 (negative), it flips the sign bit back
+//  if sign is 0 (positive), it flips all bits back
+// ================================================================================================
+inline uint32_t IFloatFlip(uint32_t f) {
+  uint32_t mask = ((f >> 31) - 1) | 0x80000000;
+  return f ^ mask;
+}
+
+// ================================================================================================
+// flip a double for sorting / flip it back: same as above, on 64 bits
+// ================================================================================================
+inline uint64_t DoubleFlip(uint64_t f) {
+  uint64_t mask = -int64_t(f >> 63) | 0x8000000000000000ull;
+  return f ^ mask;
+}
+
+inline uint64_t IDoubleFlip(uint64_t f) {
+  uint64_t mask = ((f >> 63) - 1) | 0x8000000000000000ull;
+  return f ^ mask;
+}
+
+// ================================================================================================
+// key traits: map each key type onto an unsigned integer that sorts in the same order
+// ================================================================================================
+struct FloatKeys {
+  using Key = uint32_t;
+  static Key Encode(Key k) { return FloatFlip(k); }
+  static Key Decode(Key k) { return IFloatFlip(k); }
+};
+
+struct DoubleKeys {
+  using Key = uint64_t;
+  static Key Encode(Key k) { return DoubleFlip(k); }
+  static Key Decode(Key k) { return IDoubleFlip(k); }
+};
+
+// two's complement: flipping the sign bit orders signed keys as unsigned ones
+template <typename T>
+struct SignedKeys {
+  using Key = T;
+  static constexpr Key kSign = Key(1) << (sizeof(Key) * 8 - 1);
+  static Key Encode(Key k) { return k ^ kSign; }
+  static Key Decode(Key k) { return k ^ kSign; }
+};
+
+template <typename T>
+struct UnsignedKeys {
+  using Key = T;
+  static Key Encode(Key k) { return k; }
+  static Key Decode(Key k) { return k; }
+};
+
+// ================================================================================================
+// one scatter pass: read/write histogram, copy src -> dst
+//  kEncode: flip keys on the way in (first pass reads the caller's keys)
+//  kDecode: flip keys back on the way out (last pass writes the result)
+//  kPrefetch: fetch src 'srcDistance' elements ahead, and the destination line of the key
+//             'dstDistance' elements ahead (its bucket will have moved on by a few slots at most)
+// ================================================================================================
+template <typename Traits, uint32_t kMask, bool kEncode, bool kDecode,
+          bool kPrefetch>
+void ScatterLoop(const typename Traits::Key *src, typename Traits::Key *dst,
+                 uint32_t *b, uint32_t shift, uint32_t elements,
+                 const RadixPrefetch &pf) {
+  using Key = typename Traits::Key;
+  uint32_t i = 0;
+
+  auto scatter = [&](uint32_t i) {
+    Key si = src[i];
+    if (kEncode) si = Traits::Encode(si);
+    uint32_t pos = uint32_t(si >> shift) & kMask;
+
+    if (kPrefetch && pf.srcDistance)
+      Prefetch<false>(src + i + pf.srcDistance, pf.srcHint);
+    dst[++b[pos]] = kDecode ? Traits::Decode(si) : si;
+  };
+
+  if (kPrefetch && pf.dstDistance) {
+    for (; i + pf.dstDistance < elements; i++) {
+      Key ai = src[i + pf.dstDistance];
+      if (kEncode) ai = Traits::Encode(ai);
+      Prefetch<true>(dst + b[uint32_t(ai >> shift) & kMask] + 1, pf.dstHint);
+
+      scatter(i);
+    }
+  }
+
+  for (; i < elements; i++) {
+    scatter(i);
+  }
+}
+
+template <typename Traits, uint32_t kMask, bool kEncode, bool kDecode>
+void ScatterPass(const typename Traits::Key *src, typename Traits::Key *dst,
+                 uint32_t *b, uint32_t shift, uint32_t elements,
+                 const RadixPrefetch &pf) {
+  if (pf.srcDistance || pf.dstDistance) {
+    ScatterLoop<Traits, kMask, kEncode, kDecode, true>(src, dst, b, shift,
+                                                       elements, pf);
+  } else {
+    ScatterLoop<Traits, kMask, kEncode, kDecode, false>(src, dst, b, shift,
+                                                        elements, pf);
+  }
+}
+
+// ================================================================================================
+// write one 64-byte line to 'dst' (64-byte aligned) bypassing the cache
+// ================================================================================================
+inline void StreamLine(void *dst, const void *line) {
+#if STREAM_STORES && defined(__AVX__)
+  const __m256i *s = (const __m256i *)line;
+  __m256i *d = (__m256i *)dst;
+  _mm256_stream_si256(d, _mm256_load_si256(s));
+  _mm256_stream_si256(d + 1, _mm256_load_si256(s + 1));
+#elif STREAM_STORES
+  const __m128i *s = (const __m128i *)line;
+  __m128i *d = (__m128i *)dst;
+  _mm_stream_si128(d, _mm_load_si128(s));
+  _mm_stream_si128(d + 1, _mm_load_si128(s + 1));
+  _mm_stream_si128(d + 2, _mm_load_si128(s + 2));
+  _mm_stream_si128(d + 3, _mm_load_si128(s + 3));
+#else
+  memcpy(dst, line, 64);
+#endif
+}
+
+// ================================================================================================
+// last scatter pass through per-bucket line buffers: keys collect in a 64-byte buffer per bucket,
+// and each destination cache line that lies wholly inside one bucket is written with a single
+// streaming store, so the output never gets read-for-ownership into the cache. Lines shared by two
+// buckets (at most one at each bucket edge) go out with normal stores. The line buffers (up to
+// 128 KB) are allocated once per thread and kept for its later calls; the bucket starts live on the
+// stack like the histograms.
+// ================================================================================================
+template <typename Traits, uint32_t kMask, bool kDecode>
+void StreamScatterPass(const typename Traits::Key *src,
+                       typename Traits::Key *dst, uint32_t *b, uint32_t shift,
+                       uint32_t elements, const RadixPrefetch &pf) {
+  using Key = typename Traits::Key;
+  constexpr uint32_t kHist = kMask + 1;
+  constexpr uint32_t kLine = 64 / sizeof(Key);
+  struct alignas(64) Line {
+    Key k[kLine];
+  };
+
+  static thread_local std::unique_ptr<Line[]> buffers;
+  if (!buffers) buffers.reset(new Line[kHist]);
+  Line *lines = buffers.get();
+  uint32_t start[kHist];
+  uint32_t i;
+
+  for (i = 0; i < kHist; i++) {
+    start[i] = b[i] + 1;
+  }
+
+  // slot of position q within its destination cache line
+  const uint32_t off = uint32_t((uintptr_t)dst / sizeof(Key)) & (kLine - 1);
+  auto slotOf = [off](uint32_t q) { return (q + off) & (kLine - 1); };
+
+  // copy positions [first, last] of bucket 'pos' out of its line buffer
+  auto flushPartial = [&](uint32_t pos, uint32_t first, uint32_t last) {
+    for (uint32_t q = first; q <= last; q++) {
+      dst[q] = lines[pos].k[slotOf(q)];
+    }
+  };
+
+  for (i = 0; i < elements; i++) {
+    Key si = src[i];
+    uint32_t pos = uint32_t(si >> shift) & kMask;
+
+    if (pf.srcDistance) Prefetch<false>(src + i + pf.srcDistance, pf.srcHint);
+    uint32_t q = ++b[pos];
+    uint32_t slot = slotOf(q);
+    lines[pos].k[slot] = kDecode ? Traits::Decode(si) : si;
+
+    if (slot == kLine - 1) {
+      if (q >= slot && q - slot >= start[pos]) {
+        StreamLine(dst + (q - slot), lines[pos].k);
+      } else {
+        flushPartial(pos, start[pos], q);
+      }
+    }
+  }
+
+  // tails: whatever is left in each bucket's buffer
+  for (i = 0; i < kHist; i++) {
+    uint32_t last = b[i];
+    uint32_t slot = slotOf(last);
+    if (last + 1 == start[i] || slot == kLine - 1) continue;
+
+    uint32_t first =
+        last >= slot && last - slot >= start[i] ? last - slot : start[i];
+    flushPartial(i, first, last);
+  }
+
+#if STREAM_STORES
+  _mm_sfence();
+#endif
+}
+
+// ================================================================================================
+// histogram pass: one read of 'array' counts every digit of every key into kPasses histograms of
+// 2^kBits entries at 'b0' (which the caller zeroes)
+// ================================================================================================
+template <typename Traits, uint32_t kBits>
+void HistogramPass(const typename Traits::Key *array, uint32_t *b0,
+                   uint32_t elements, const RadixPrefetch &pf) {
+  using Key = typename Traits::Key;
+  constexpr uint32_t kPasses = (sizeof(Key) * 8 + kBits - 1) / kBits;
+  constexpr uint32_t kHist = 1u << kBits;
+  constexpr uint32_t kMask = kHist - 1;
+  uint32_t i;
+
+  auto count = [&](uint32_t i) {
+    Key fi = Traits::Encode(array[i]);
+
+    for (uint32_t p = 0; p < kPasses; p++) {
+      b0[p * kHist + (uint32_t(fi >> (p * kBits)) & kMask)]++;
+    }
+  };
+
+  if (pf.srcDistance) {
+    for (i = 0; i < elements; i++) {
+      Prefetch<false>(array + i + pf.srcDistance, pf.srcHint);
+      count(i);
+    }
+  } else {
+    for (i = 0; i < elements; i++) {
+      count(i);
+    }
+  }
+}
+
+// ================================================================================================
+// Sum the histograms -- each histogram entry records the number of values preceding itself, less
+// one (the scatter pre-increments).
+// ================================================================================================
+template <uint32_t kHist, uint32_t kPasses>
+void PrefixSum(uint32_t *b0) {
+  uint32_t sum[kPasses] = {};
+  uint32_t tsum;
+  for (uint32_t i = 0; i < kHist; i++) {
+    for (uint32_t p = 0; p < kPasses; p++) {
+      tsum = b0[p * kHist + i] + sum[p];
+      b0[p * kHist + i] = sum[p] - 1;
+      sum[p] = tsum;
+    }
+  }
+}
+
@@ -0,0 +1,378 @@
+// radix_micro.cpp
+// Microbenchmarks of the passes RadixSort11 and the RadixSortKeys engines are built from, one
+// kernel at a time, on the same code the sorts run (radix_kernels.h): FloatFlip, the histogram
+// pass at each digit width, the prefix sum, and the scatter pass at each fan-out over several
+// digit distributions, with and without software prefetch and write-combining (streaming) stores.
+// Reports cycles per element, so one pass can be tuned without rerunning the sort matrix.
+//
+// Usage: radix-micro [--log2=N] [--reps=R] [--pf-src=D] [--pf-dst=D] [--pin=CPU]
+//                    [--kernels=flip,histogram,prefix,scatter]
+
+// Standard Library Headers
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Project Headers
+#include "perf_counters.h"
+#include "philox.h"
+#include "radix_kernels.h"
+#include "sysinfo.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define RADIX_MICRO_TSC 1
+#elif defined(_M_X64) || defined(_M_IX86)
+#include <intrin.h>
+#define RADIX_MICRO_TSC 1
+#else
+#define RADIX_MICRO_TSC 0
+#endif
+
+// ------------------------------------------------------------------------------------------------
+// Config parameters
+
+using Clock = std::chrono::steady_clock;
+
+struct MicroOptions
+{
+    int log2 = 20; // keys per kernel call: 2^log2
+    int reps = 11; // timed calls per kernel; the median is reported
+    int pin = -1;  // logical CPU to pin to, -1 = don't
+
+    // distances of the "prefetch" variants (--pf-src, --pf-dst)
+    RadixPrefetch pf = {128, RadixPrefetchHint::T0, 8, RadixPrefetchHint::T0};
+    std::string kernels = "flip,histogram,prefix,scatter";
+};
+
+// Digit distributions the scatter runs over: which bucket each key lands in.
+enum class DigitDist
+{
+    Uniform, // random digits
+    Skewed,  // top digit of floats in [-16, 16]: a handful of buckets take every key
+    Sorted,  // digits already in order, so each bucket fills in one run
+    Single,  // every key in one bucket
+};
+
+static const char *kDigitDistNames[] = {"uniform", "skewed", "sorted", "single"};
+
+// ------------------------------------------------------------------------------------------------
+// Cycle counting
+
+// Cycles of one region: core cycles from perf_event_open where the machine gives them, else the
+// time-stamp counter (reference cycles), else steady_clock nanoseconds.
+class CycleClock
+{
+  public:
+    CycleClock()
+    {
+        counters_.start();
+        valid_ = counters_.stop().valid[kPerfCycles];
+    }
+
+    const char *unit() const
+    {
+        if (valid_)
+            return "core cycles";
+#if RADIX_MICRO_TSC
+        return "TSC cycles";
+#else
+        return "ns";
+#endif
+    }
+
+    void start()
+    {
+        if (valid_)
+            counters_.start();
+        else
+            t0_ = now();
+    }
+
+    double stop()
+    {
+        if (valid_)
+            return counters_.stop().value[kPerfCycles];
+        return double(now() - t0_);
+    }
+
+  private:
+    static uint64_t now()
+    {
+#if RADIX_MICRO_TSC
+        return __rdtsc();
+#else
+        auto since = Clock::now().time_since_epoch();
+        return uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(since).count());
+#endif
+    }
+
+    PerfCounters counters_;
+    bool valid_ = false;
+    uint64_t t0_ = 0;
+};
+
+// median of 'reps' timed calls of 'kernel', 'setup' run untimed before each (and one untimed call
+// first to warm up)
+template <typename Setup, typename Kernel>
+double medianCycles(CycleClock &clock, int reps, Setup setup, Kernel kernel)
+{
+    setup();
+    kernel();
+
+    std::vector<double> cycles;
+    for (int r = 0; r < reps; ++r)
+    {
+        setup();
+        clock.start();
+        kernel();
+        cycles.push_back(clock.stop());
+    }
+    std::nth_element(cycles.begin(), cycles.begin() + cycles.size() / 2, cycles.end());
+    return cycles[cycles.size() / 2];
+}
+
+// ------------------------------------------------------------------------------------------------
+// Utility functions
+
+bool parseArgs(int argc, char **argv, MicroOptions &opts)
+{
+    for (int i = 1; i < argc; ++i)
+    {
+        const char *arg = argv[i];
+        const char *eq = std::strchr(arg, '=');
+        std::string name(arg, eq ? size_t(eq - arg) : std::strlen(arg));
+        const char *value = eq ? eq + 1 : "";
+
+        if (name == "--log2" && *value)
+            opts.log2 = std::clamp(std::atoi(value), 8, 30);
+        else if (name == "--reps" && *value)
+            opts.reps = std::max(1, std::atoi(value));
+        else if (name == "--pf-src" && *value)
+            opts.pf.srcDistance = uint32_t(std::strtoul(value, nullptr, 10));
+        else if (name == "--pf-dst" && *value)
+            opts.pf.dstDistance = uint32_t(std::strtoul(value, nullptr, 10));
+        else if (name == "--pin" && *value)
+            opts.pin = std::atoi(value);
+        else if (name == "--kernels" && *value)
+            opts.kernels = value;
+        else
+        {
+            std::cerr << "unknown option '" << arg << "'\n"
+                      << "usage: radix-micro [--log2=N] [--reps=R] [--pf-src=D] [--pf-dst=D] [--pin=CPU]\n"
+                      << "                   [--kernels=flip,histogram,prefix,scatter]\n";
+            return false;
+        }
+    }
+    return true;
+}
+
+// 'kernel' is in the comma-separated --kernels list
+bool selected(const MicroOptions &opts, const char *kernel)
+{
+    std::string list = "," + opts.kernels + ",";
+    return list.find("," + std::string(kernel) + ",") != std::string::npos;
+}
+
+// the bit pattern of 'n' floats uniform in [-16, 16], as the sort's random input
+std::vector<uint32_t> randomFloatBits(uint32_t n)
+{
+    std::vector<uint32_t> keys(n);
+    Philox rng(1234, 0, 0);
+    for (uint32_t &k : keys)
+    {
+        float f = (float(rng()) * (1.0f / 4294967296.0f)) * 32.0f - 16.0f;
+        std::memcpy(&k, &f, sizeof(k));
+    }
+    return keys;
+}
+
+void printRow(const char *kernel, const std::string &variant, double cycles, uint32_t n)
+{
+    std::cout << std::left << std::setw(12) << kernel << std::setw(28) << variant << std::right << std::setw(14)
+              << cycles / n << std::setw(16) << std::setprecision(0) << cycles << std::setprecision(2) << "\n";
+}
+
+// ------------------------------------------------------------------------------------------------
+// Kernels
+
+// FloatFlip on the way into the first pass, IFloatFlip on the way out of the last: src -> dst
+void benchFlip(const MicroOptions &opts, CycleClock &clock, const std::vector<uint32_t> &keys)
+{
+    uint32_t n = uint32_t(keys.size());
+    std::vector<uint32_t> dst(n);
+    auto none = [] {};
+
+    double flip = medianCycles(clock, opts.reps, none, [&] {
+        for (uint32_t i = 0; i < n; ++i)
+            dst[i] = FloatFlip(keys[i]);
+    });
+    printRow("flip", "FloatFlip", flip, n);
+
+    double unflip = medianCycles(clock, opts.reps, none, [&] {
+        for (uint32_t i = 0; i < n; ++i)
+            dst[i] = IFloatFlip(keys[i]);
+    });
+    printRow("flip", "IFloatFlip", unflip, n);
+}
+
+// the histogram pass at one digit width: every digit of every key in one read
+template <uint32_t kBits>
+void benchHistogram(const MicroOptions &opts, CycleClock &clock, const std::vector<uint32_t> &keys)
+{
+    constexpr uint32_t kPasses = (32 + kBits - 1) / kBits;
+    constexpr uint32_t kHist = 1u << kBits;
+    uint32_t n = uint32_t(keys.size());
+    std::vector<uint32_t> b0(kHist * kPasses);
+    auto clear = [&] { std::fill(b0.begin(), b0.end(), 0); };
+    std::string digits = std::to_string(kPasses) + "x" + std::to_string(kHist);
+
+    double plain = medianCycles(clock, opts.reps, clear, [&] {
+        HistogramPass<FloatKeys, kBits>(keys.data(), b0.data(), n, RadixPrefetch());
+    });
+    printRow("histogram", digits, plain, n);
+
+    RadixPrefetch pf;
+    pf.srcDistance = opts.pf.srcDistance;
+    double prefetched = medianCycles(clock, opts.reps, clear, [&] {
+        HistogramPass<FloatKeys, kBits>(keys.data(), b0.data(), n, pf);
+    });
+    printRow("histogram", digits + " prefetch " + std::to_string(pf.srcDistance), prefetched, n);
+}
+
+// the prefix sums over every histogram of one digit width (per call; per element of the sort's n)
+template <uint32_t kBits>
+void benchPrefix(const MicroOptions &opts, CycleClock &clock, const std::vector<uint32_t> &keys)
+{
+    constexpr uint32_t kPasses = (32 + kBits - 1) / kBits;
+    constexpr uint32_t kHist = 1u << kBits;
+    uint32_t n = uint32_t(keys.size());
+    std::vector<uint32_t> counts(kHist * kPasses, 0), b0(kHist * kPasses);
+    HistogramPass<FloatKeys, kBits>(keys.data(), counts.data(), n, RadixPrefetch());
+
+    double cycles = medianCycles(
+        clock, opts.reps, [&] { b0 = counts; }, [&] { PrefixSum<kHist, kPasses>(b0.data()); });
+    printRow("prefix", std::to_string(kPasses) + "x" + std::to_string(kHist), cycles, n);
+}
+
+// one middle scatter pass (no flips) at a fan-out of 2^kBits, for each digit distribution: plain,
+// with source and destination prefetch, and (up to 11-bit digits, as in the sorts) through the
+// write-combining line buffers of the streamed final pass
+template <uint32_t kBits>
+void benchScatter(const MicroOptions &opts, CycleClock &clock, const std::vector<uint32_t> &floatKeys)
+{
+    constexpr uint32_t kHist = 1u << kBits;
+    constexpr uint32_t kMask = kHist - 1;
+    uint32_t n = uint32_t(floatKeys.size());
+    std::vector<uint32_t> keys(n), dst(n), start(kHist), b(kHist);
+    Philox rng(4321, 0, 0);
+
+    for (int d = 0; d < 4; ++d)
+    {
+        // keys whose digit at 'shift' follows the distribution
+        uint32_t shift = 0;
+        switch (DigitDist(d))
+        {
+        case DigitDist::Uniform:
+            for (uint32_t &k : keys)
+                k = rng();
+            break;
+        case DigitDist::Skewed:
+            for (uint32_t i = 0; i < n; ++i)
+                keys[i] = FloatFlip(floatKeys[i]);
+            shift = 32 - kBits;
+            break;
+        case DigitDist::Sorted:
+            for (uint32_t i = 0; i < n; ++i)
+                keys[i] = uint32_t(uint64_t(i) * kHist / n);
+            break;
+        case DigitDist::Single:
+            for (uint32_t &k : keys)
+                k = rng() & ~kMask;
+            break;
+        }
+
+        std::fill(start.begin(), start.end(), 0);
+        for (uint32_t k : keys)
+            ++start[(k >> shift) & kMask];
+        PrefixSum<kHist, 1>(start.data());
+        auto reset = [&] { b = start; };
+
+        std::string variant = std::to_string(kHist) + " " + kDigitDistNames[d];
+        double plain = medianCycles(clock, opts.reps, reset, [&] {
+            ScatterPass<UnsignedKeys<uint32_t>, kMask, false, false>(keys.data(), dst.data(), b.data(), shift, n,
+                                                                     RadixPrefetch());
+        });
+        printRow("scatter", variant, plain, n);
+
+        double prefetched = medianCycles(clock, opts.reps, reset, [&] {
+            ScatterPass<UnsignedKeys<uint32_t>, kMask, false, false>(keys.data(), dst.data(), b.data(), shift, n,
+                                                                     opts.pf);
+        });
+        printRow("scatter",
+                 variant + " prefetch " + std::to_string(opts.pf.srcDistance) + "/" +
+                     std::to_string(opts.pf.dstDistance),
+                 prefetched, n);
+
+        if constexpr (kBits <= 11)
+        {
+            double streamed = medianCycles(clock, opts.reps, reset, [&] {
+                StreamScatterPass<UnsignedKeys<uint32_t>, kMask, false>(keys.data(), dst.data(), b.data(), shift, n,
+                                                                        RadixPrefetch());
+            });
+            printRow("scatter", variant + " wc", streamed, n);
+        }
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
+// Main
+
+int main(int argc, char **argv)
+{
+    MicroOptions opts;
+    if (!parseArgs(argc, argv, opts))
+        return 1;
+
+    if (opts.pin >= 0 && !pinToCpu(opts.pin))
+        std::cerr << "warning: could not pin to CPU " << opts.pin << "\n";
+    warnAboutNoise(opts.pin >= 0 ? opts.pin : currentCpu());
+
+    uint32_t n = 1u << opts.log2;
+    std::vector<uint32_t> keys = randomFloatBits(n);
+    CycleClock clock;
+
+    std::cout << "\n=== Radix kernels, " << n << " keys (" << clock.unit() << ", median of " << opts.reps
+              << " calls) ===\n";
+    std::cout << std::fixed << std::setprecision(2) << std::left << std::setw(12) << "Kernel" << std::setw(28)
+              << "Variant" << std::right << std::setw(14) << "per element" << std::setw(16) << "per call" << "\n";
+
+    if (selected(opts, "flip"))
+        benchFlip(opts, clock, keys);
+    if (selected(opts, "histogram"))
+    {
+        benchHistogram<8>(opts, clock, keys);
+        benchHistogram<11>(opts, clock, keys);
+        benchHistogram<16>(opts, clock, keys);
+    }
+    if (selected(opts, "prefix"))
+    {
+        benchPrefix<8>(opts, clock, keys);
+        benchPrefix<11>(opts, clock, keys);
+        benchPrefix<16>(opts, clock, keys);
+    }
+    if (selected(opts, "scatter"))
+    {
+        benchScatter<8>(opts, clock, keys);
+        benchScatter<11>(opts, clock, keys);
+        benchScatter<16>(opts, clock, keys);
+    }
+    return 0;
+}
@@ -0,0 +1,120 @@
+// radix_scratch.cpp: page-aligned scratch buffers, optionally prefaulted and locked
+
+#include "radix_scratch.h"
+
+#include <stdlib.h>
+
+#include <thread>
+#include <vector>
+
+#if defined(__linux__) || defined(__APPLE__)
+#include <sys/mman.h>
+#include <unistd.h>
+#define RADIX_SCRATCH_MMAP 1
+#else
+#define RADIX_SCRATCH_MMAP 0
+#endif
+
+#if defined(_WIN32)
+#include <malloc.h>
+#endif
+
+static const size_t kFallbackPageBytes = 4096;
+static const size_t kTouchBytesPerThread = 1u << 22; // below this, a thread costs more than it saves
+
+static size_t PageBytes()
+{
+#if RADIX_SCRATCH_MMAP
+    long page = sysconf(_SC_PAGESIZE);
+    return page > 0 ? size_t(page) : kFallbackPageBytes;
+#else
+    return kFallbackPageBytes;
+#endif
+}
+
+// one write per page of [data, data + bytes), in contiguous ranges across 'threads' threads
+static void TouchPages(void *data, size_t bytes, size_t page, uint32_t threads)
+{
+    size_t pages = (bytes + page - 1) / page;
+    if (threads == 0)
+        threads = std::thread::hardware_concurrency();
+    size_t most = bytes / kTouchBytesPerThread;
+    if (threads > most)
+        threads = uint32_t(most);
+    if (threads < 1)
+        threads = 1;
+
+    auto touch = [=](uint32_t t) {
+        volatile char *base = static_cast<char *>(data);
+        for (size_t p = pages * t / threads; p < pages * (t + 1) / threads; ++p)
+            base[p * page] = 0;
+    };
+    std::vector<std::thread> pool;
+    for (uint32_t t = 1; t < threads; ++t)
+        pool.emplace_back(touch, t);
+    touch(0);
+    for (std::thread &th : pool)
+        th.join();
+}
+
+RadixScratch RadixAllocScratch(size_t bytes, const RadixScratchOptions &options)
+{
+    RadixScratch scratch;
+    if (bytes == 0)
+        return scratch;
+
+    const size_t page = PageBytes();
+    const size_t rounded = (bytes + page - 1) / page * page;
+    bool populated = false;
+
+#if RADIX_SCRATCH_MMAP
+    int flags = MAP_PRIVATE | MAP_ANONYMOUS;
+#if defined(MAP_POPULATE)
+    if (options.prefault == RadixPrefault::Populate)
+    {
+        flags |= MAP_POPULATE;
+        populated = true;
+    }
+#endif
+    void *memory = mmap(nullptr, rounded, PROT_READ | PROT_WRITE, flags, -1, 0);
+    if (memory == MAP_FAILED)
+        return scratch;
+#elif defined(_WIN32)
+    void *memory = _aligned_malloc(rounded, page);
+    if (!memory)
+        return scratch;
+#else
+    void *memory = aligned_alloc(page, rounded);
+    if (!memory)
+        return scratch;
+#endif
+    scratch.data = memory;
+    scratch.bytes = bytes;
+
+    if (options.prefault != RadixPrefault::None && !populated)
+        TouchPages(memory, rounded, page, options.threads);
+#if RADIX_SCRATCH_MMAP
+    // mlock faults in whatever isn't resident yet
+    if (options.lock)
+        scratch.locked = mlock(memory, rounded) == 0;
+#endif
+    return scratch;
+}
+
+void RadixFreeScratch(RadixScratch &scratch)
+{
+    if (!scratch.data)
+        return;
+#if RADIX_SCRATCH_MMAP
+    const size_t page = PageBytes();
+    const size_t rounded = (scratch.bytes + page - 1) / page * page;
+    if (scratch.locked)
+        munlock(scratch.data, rounded);
+    munmap(scratch.data, rounded);
+#elif defined(_WIN32)
+    _aligned_free(scratch.data);
+#else
+    free(scratch.data);
+#endif
+    scratch = RadixScratch();
+}
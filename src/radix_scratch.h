@@ -0,0 +1,43 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Scratch buffers for the radix engines (the 'scratch' of RadixSortKeys and RadixSort, the 'sorted'
+// of RadixSort11). Freshly mapped memory has no pages behind it yet, so the first sort into a new
+// buffer takes a page fault per 4 KB it writes -- at 2^24 floats that is 16K faults inside the
+// sort. RadixAllocScratch can pay for them up front instead, and lock the pages so they stay
+// resident for latency-critical callers.
+
+// How a new buffer gets its pages before it is handed out.
+enum class RadixPrefault : uint8_t
+{
+    None,     // on first touch, inside the first sort
+    Populate, // by the kernel at mapping time (MAP_POPULATE on Linux; elsewhere, as Touch)
+    Touch,    // one write per page, split across threads
+};
+
+struct RadixScratchOptions
+{
+    RadixPrefault prefault = RadixPrefault::None;
+    uint32_t threads = 0; // Touch: threads writing the pages, 0 = one per hardware thread
+    bool lock = false;    // mlock the pages as well (needs RLIMIT_MEMLOCK room; see RadixScratch::locked).
+                          // POSIX only: elsewhere it is ignored and RadixScratch::locked stays false
+};
+
+struct RadixScratch
+{
+    void *data = nullptr; // page-aligned; nullptr if the allocation failed
+    size_t bytes = 0;     // as asked for
+    bool locked = false;  // the lock was asked for and granted
+};
+
+// At least 'bytes' of page-aligned memory. Release it with RadixFreeScratch.
+RadixScratch RadixAllocScratch(size_t bytes, const RadixScratchOptions &options = {});
+void RadixFreeScratch(RadixScratch &scratch);
+
+// Typed view: room for 'count' keys of type T.
+template <typename T> RadixScratch RadixAllocScratchFor(size_t count, const RadixScratchOptions &options = {})
+{
+    return RadixAllocScratch(count * sizeof(T), options);
+}
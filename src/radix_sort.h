@@ -0,0 +1,125 @@
+#pragma once
+
+// Header-only front end for the radix engines in radix.h. Accepts std::vector, std::array, C
+// arrays, pointers and std::vector iterators, dispatches on the element type at compile time and
+// sorts without copying: the result stays in whichever buffer the last pass wrote, and the returned
+// range points there.
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+#include "radix.h"
+
+// ------------------------------------------------------------------------------------------------
+// Key type dispatch
+
+// Maps a key type onto the engine instantiated for it: float, double, or the fixed-width integer
+// of the same size and signedness (so 'int', 'long', 'unsigned long long' etc. all resolve).
+template <typename T, typename = void> struct RadixEngineKey
+{
+};
+
+template <> struct RadixEngineKey<float>
+{
+    using type = float;
+};
+
+template <> struct RadixEngineKey<double>
+{
+    using type = double;
+};
+
+template <typename T>
+struct RadixEngineKey<T, std::enable_if_t<std::is_integral_v<T> && !std::is_same_v<T, bool> &&
+                                          (sizeof(T) == 4 || sizeof(T) == 8)>>
+{
+    using type = std::conditional_t<std::is_signed_v<T>, std::conditional_t<sizeof(T) == 4, int32_t, int64_t>,
+                                    std::conditional_t<sizeof(T) == 4, uint32_t, uint64_t>>;
+};
+
+template <typename T, typename = void> struct RadixIsKey : std::false_type
+{
+};
+
+template <typename T> struct RadixIsKey<T, std::void_t<typename RadixEngineKey<T>::type>> : std::true_type
+{
+};
+
+// Iterators known to walk contiguous memory: C++17 has no tag for them, so this takes pointers
+// (which is what std::array's iterators are in libstdc++ and libc++) and std::vector's iterators.
+template <typename It, typename V = typename std::iterator_traits<It>::value_type>
+struct RadixIsContiguousIterator
+    : std::bool_constant<std::is_pointer_v<It> || std::is_same_v<It, typename std::vector<V>::iterator>>
+{
+};
+
+// ------------------------------------------------------------------------------------------------
+// Result
+
+// The sorted keys: points into either the caller's keys or the scratch buffer, depending on the
+// number of passes the engine ran.
+template <typename T> struct RadixSortResult
+{
+    T *first = nullptr;
+    size_t count = 0;
+    bool inScratch = false;
+
+    T *data() const { return first; }
+    size_t size() const { return count; }
+    T *begin() const { return first; }
+    T *end() const { return first + count; }
+};
+
+// ------------------------------------------------------------------------------------------------
+// Front end
+
+// Sorts 'count' keys at 'keys', using 'scratch' (at least 'count' entries) as the ping-pong buffer.
+template <typename T>
+RadixSortResult<T> RadixSortContiguous(T *keys, T *scratch, size_t count, const RadixOptions &options)
+{
+    static_assert(!std::is_const_v<T>, "RadixSort needs mutable keys");
+    static_assert(RadixIsKey<T>::value, "RadixSort supports float, double and 32/64-bit integer keys");
+    assert(count <= UINT32_MAX);
+
+    if (count == 0)
+    {
+        return {keys, 0, false};
+    }
+
+    using E = typename RadixEngineKey<T>::type;
+    E *out = RadixSortKeys(reinterpret_cast<E *>(keys), reinterpret_cast<E *>(scratch), uint32_t(count), options);
+    return {reinterpret_cast<T *>(out), count, reinterpret_cast<T *>(out) == scratch};
+}
+
+// Iterator form: [first, last) and the range starting at 'scratch', as pointers or std::vector
+// iterators. Other containers' iterators don't compile, even random-access ones like std::deque's,
+// whose elements aren't contiguous; pass such data through a pointer or the range form instead.
+template <typename It, typename ScratchIt, typename = typename std::iterator_traits<It>::iterator_category>
+auto RadixSort(It first, It last, ScratchIt scratch, const RadixOptions &options = {})
+{
+    static_assert(RadixIsContiguousIterator<It>::value && RadixIsContiguousIterator<ScratchIt>::value,
+                  "RadixSort needs contiguous iterators: pointers or std::vector iterators");
+    using T = std::remove_reference_t<decltype(*first)>;
+    static_assert(std::is_same_v<T, std::remove_reference_t<decltype(*scratch)>>,
+                  "keys and scratch must have the same element type");
+
+    size_t count = size_t(last - first);
+    if (count == 0)
+    {
+        return RadixSortResult<T>{};
+    }
+    return RadixSortContiguous(std::addressof(*first), std::addressof(*scratch), count, options);
+}
+
+// Range form: anything with std::data/std::size (std::vector, std::array, C arrays).
+template <typename Range, typename Scratch>
+auto RadixSort(Range &&keys, Scratch &&scratch, const RadixOptions &options = {})
+{
+    assert(std::size(scratch) >= std::size(keys));
+    return RadixSortContiguous(std::data(keys), std::data(scratch), std::size(keys), options);
+}
@@ -0,0 +1,262 @@
+// radix_stat.cpp
+// Reads the radix engines' shared-memory telemetry page (radix_telemetry.h) from outside the process
+// that sorts, without stopping it.
+//
+// Usage: radix-stat                                  list the pages in /dev/shm
+//        radix-stat PID|NAME [--threads] [--watch=S]
+
+// Standard Library Headers
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+
+// System Headers
+#include <dirent.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Project Headers
+#include "radix_telemetry.h"
+
+static const char *kPathNames[kRadixPathCount] = {"Insertion", "8-bit", "11-bit", "16-bit", "Parallel"};
+
+// Sum of some slots, or of all of them.
+struct Totals
+{
+    uint64_t calls = 0;
+    uint64_t elements = 0;
+    uint64_t bytes = 0;
+    uint64_t ticks = 0;
+    uint64_t paths[kRadixPathCount] = {};
+
+    void add(const RadixTelemetrySlot &slot)
+    {
+        calls += slot.calls.load(std::memory_order_relaxed);
+        elements += slot.elements.load(std::memory_order_relaxed);
+        bytes += slot.bytes.load(std::memory_order_relaxed);
+        ticks += slot.ticks.load(std::memory_order_relaxed);
+        for (int p = 0; p < kRadixPathCount; ++p)
+            paths[p] += slot.paths[p].load(std::memory_order_relaxed);
+    }
+};
+
+static uint32_t slotsUsed(const RadixTelemetryPage &page)
+{
+    return std::min(page.slotsUsed.load(std::memory_order_relaxed), page.slotCount);
+}
+
+// slots a live thread holds right now
+static uint32_t slotsHeld(const RadixTelemetryPage &page)
+{
+    uint32_t held = 0;
+    for (uint32_t s = 0; s < slotsUsed(page); ++s)
+        held += page.slots[s].owned.load(std::memory_order_relaxed);
+    return held;
+}
+
+// "tid 1234", "+N" when N earlier threads' calls are in the slot too, and "exited" once nobody holds it
+static std::string slotLabel(const RadixTelemetrySlot &slot)
+{
+    std::string label = "tid " + std::to_string(slot.threadId.load(std::memory_order_relaxed));
+    uint32_t owners = slot.owners.load(std::memory_order_relaxed);
+    if (owners > 1)
+        label += " +" + std::to_string(owners - 1);
+    if (!slot.owned.load(std::memory_order_relaxed))
+        label += " exited";
+    return label;
+}
+
+static Totals sumSlots(const RadixTelemetryPage &page)
+{
+    Totals totals;
+    for (uint32_t s = 0; s < slotsUsed(page); ++s)
+        totals.add(page.slots[s]);
+    return totals;
+}
+
+static bool processAlive(uint64_t pid)
+{
+    return kill(pid_t(pid), 0) == 0 || errno == EPERM;
+}
+
+// "1234" -> "/radix-telemetry.1234"; names are taken as they are, with a leading '/' added
+static std::string pageName(const std::string &arg)
+{
+    if (!arg.empty() && arg.find_first_not_of("0123456789") == std::string::npos)
+        return "/radix-telemetry." + arg;
+    return arg[0] == '/' ? arg : "/" + arg;
+}
+
+static const RadixTelemetryPage *mapPage(const std::string &name)
+{
+    int fd = shm_open(name.c_str(), O_RDONLY, 0);
+    if (fd < 0)
+    {
+        std::cerr << "radix-stat: can't open " << name << ": " << std::strerror(errno) << "\n";
+        return nullptr;
+    }
+    // a page still being created (shm_open truncates it to 0 before ftruncate sizes it) or any other
+    // shorter object would fault on the first read past its end
+    struct stat info;
+    if (fstat(fd, &info) != 0 || size_t(info.st_size) < sizeof(RadixTelemetryPage))
+    {
+        std::cerr << "radix-stat: " << name << " is smaller than a telemetry page\n";
+        close(fd);
+        return nullptr;
+    }
+    void *memory = mmap(nullptr, sizeof(RadixTelemetryPage), PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (memory == MAP_FAILED)
+    {
+        std::cerr << "radix-stat: can't map " << name << ": " << std::strerror(errno) << "\n";
+        return nullptr;
+    }
+
+    const RadixTelemetryPage *page = static_cast<const RadixTelemetryPage *>(memory);
+    if (std::memcmp(page->magic, "RDXTELEM", 8) != 0 || page->version != kRadixTelemetryVersion ||
+        page->slotCount != kRadixTelemetrySlots)
+    {
+        std::cerr << "radix-stat: " << name << " isn't a telemetry page of this version\n";
+        munmap(memory, sizeof(RadixTelemetryPage));
+        return nullptr;
+    }
+    return page;
+}
+
+static void listPages()
+{
+    DIR *dir = opendir("/dev/shm");
+    if (!dir)
+    {
+        std::cerr << "radix-stat: can't list /dev/shm\n";
+        return;
+    }
+    while (dirent *entry = readdir(dir))
+    {
+        if (std::strncmp(entry->d_name, "radix-telemetry.", 16) != 0)
+            continue;
+        std::string name = std::string("/") + entry->d_name;
+        if (const RadixTelemetryPage *page = mapPage(name))
+        {
+            Totals totals = sumSlots(*page);
+            std::cout << name << ": pid " << page->pid << (processAlive(page->pid) ? "" : " (exited)") << ", "
+                      << slotsHeld(*page) << " threads, " << totals.calls << " calls\n";
+        }
+    }
+    closedir(dir);
+}
+
+static void printHeader()
+{
+    std::cout << std::setw(20) << "" << std::setw(14) << "Calls" << std::setw(16) << "Elements" << std::setw(12)
+              << "MB" << std::setw(12) << "Time ms" << std::setw(10) << "ns/call" << std::setw(10) << "ns/elem";
+    for (const char *name : kPathNames)
+        std::cout << std::setw(11) << name;
+    std::cout << "\n";
+}
+
+static void printRow(const std::string &label, const Totals &t, double ticksPerNs)
+{
+    double ns = double(t.ticks) / ticksPerNs;
+    std::cout << std::fixed << std::setprecision(1) << std::setw(20) << label << std::setw(14) << t.calls
+              << std::setw(16) << t.elements << std::setw(12) << t.bytes / 1e6 << std::setw(12) << ns / 1e6
+              << std::setw(10) << (t.calls ? ns / t.calls : 0.0) << std::setprecision(2) << std::setw(10)
+              << (t.elements ? ns / t.elements : 0.0);
+    for (uint64_t calls : t.paths)
+        std::cout << std::setw(11) << calls;
+    std::cout << "\n";
+}
+
+// one line per interval: call and element rates, and how much of a core the sorts kept busy
+static void watch(const RadixTelemetryPage &page, double seconds)
+{
+    std::cout << std::setw(10) << "Time s" << std::setw(14) << "Calls/s" << std::setw(14) << "Melem/s"
+              << std::setw(12) << "ns/call" << std::setw(10) << "Busy %" << std::setw(10) << "Threads" << "\n";
+
+    auto start = std::chrono::steady_clock::now();
+    Totals last = sumSlots(page);
+    while (processAlive(page.pid))
+    {
+        std::this_thread::sleep_for(std::chrono::duration<double>(seconds));
+        Totals now = sumSlots(page);
+        double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        double calls = double(now.calls - last.calls);
+        double ns = double(now.ticks - last.ticks) / page.ticksPerNs;
+
+        std::cout << std::fixed << std::setprecision(1) << std::setw(10) << elapsed << std::setw(14)
+                  << calls / seconds << std::setw(14) << (now.elements - last.elements) / seconds / 1e6
+                  << std::setw(12) << (calls ? ns / calls : 0.0) << std::setw(10) << 100.0 * ns / (seconds * 1e9)
+                  << std::setw(10) << slotsHeld(page) << std::endl;
+        last = now;
+    }
+    std::cout << "process " << page.pid << " exited\n";
+}
+
+int main(int argc, char **argv)
+{
+    std::string target;
+    bool threads = false;
+    double watchSeconds = 0;
+    for (int i = 1; i < argc; ++i)
+    {
+        const char *arg = argv[i];
+        if (std::strcmp(arg, "--threads") == 0)
+            threads = true;
+        else if (std::strncmp(arg, "--watch=", 8) == 0)
+            watchSeconds = std::max(0.01, std::atof(arg + 8));
+        else if (arg[0] != '-' && target.empty())
+            target = arg;
+        else
+        {
+            std::cerr << "usage: radix-stat                                  (list telemetry pages)\n"
+                      << "       radix-stat PID|NAME [--threads] [--watch=S]\n";
+            return 1;
+        }
+    }
+
+    if (target.empty())
+    {
+        listPages();
+        return 0;
+    }
+
+    std::string name = pageName(target);
+    const RadixTelemetryPage *page = mapPage(name);
+    if (!page)
+        return 1;
+
+    std::cout << name << ": pid " << page->pid << (processAlive(page->pid) ? "" : " (exited)") << ", "
+              << slotsHeld(*page) << " threads, " << slotsUsed(*page) << " slots used";
+    if (uint64_t unslotted = page->unslottedCalls.load(std::memory_order_relaxed))
+        std::cout << ", " << unslotted << " calls from threads past the last slot not counted";
+    std::cout << "\n\n";
+
+    if (watchSeconds > 0)
+    {
+        watch(*page, watchSeconds);
+        return 0;
+    }
+
+    printHeader();
+    if (threads)
+    {
+        for (uint32_t s = 0; s < slotsUsed(*page); ++s)
+        {
+            Totals t;
+            t.add(page->slots[s]);
+            printRow(slotLabel(page->slots[s]), t, page->ticksPerNs);
+        }
+    }
+    printRow("total", sumSlots(*page), page->ticksPerNs);
+    return 0;
+}
@@ -0,0 +1,198 @@
+// radix_telemetry.cpp: shared-memory per-thread counters for the radix engines
+
+#include "radix_telemetry.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <chrono>
+#include <functional>
+#include <new>
+#include <string>
+#include <thread>
+
+#if defined(__linux__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#define RADIX_TELEMETRY_SHM 1
+#else
+#define RADIX_TELEMETRY_SHM 0
+#endif
+
+#if defined(__linux__)
+#include <sys/syscall.h>
+#elif defined(_WIN32)
+#include <process.h>
+#define getpid _getpid
+#endif
+
+static std::atomic<bool> gEnabled{false};
+static RadixTelemetryPage *gPage = nullptr;
+static std::string gName;
+
+// timer ticks per nanosecond, from the clock's rate over 10 ms
+static double calibrateTicks()
+{
+#if RADIX_TELEMETRY_TSC
+    auto t0 = std::chrono::steady_clock::now();
+    uint64_t c0 = RadixTelemetryTicks();
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    uint64_t c1 = RadixTelemetryTicks();
+    double ns = double(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - t0)
+                           .count());
+    return ns > 0 ? double(c1 - c0) / ns : 1.0;
+#else
+    return 1.0;
+#endif
+}
+
+static uint64_t osThreadId()
+{
+#if defined(__linux__)
+    return uint64_t(syscall(SYS_gettid));
+#else
+    return uint64_t(std::hash<std::thread::id>()(std::this_thread::get_id()));
+#endif
+}
+
+static void removeName()
+{
+#if RADIX_TELEMETRY_SHM
+    if (!gName.empty())
+        shm_unlink(gName.c_str());
+#endif
+}
+
+// the page, mapped from shared memory under 'name' if possible, else from the heap
+static RadixTelemetryPage *mapPage(const std::string &name, bool &shared)
+{
+    shared = false;
+    void *memory = nullptr;
+#if RADIX_TELEMETRY_SHM
+    int fd = shm_open(name.c_str(), O_CREAT | O_RDWR | O_TRUNC, 0644);
+    if (fd >= 0)
+    {
+        if (ftruncate(fd, sizeof(RadixTelemetryPage)) == 0)
+        {
+            memory = mmap(nullptr, sizeof(RadixTelemetryPage), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+            if (memory == MAP_FAILED)
+                memory = nullptr;
+        }
+        close(fd);
+        if (memory)
+            shared = true;
+        else
+            shm_unlink(name.c_str());
+    }
+#endif
+    if (!memory)
+        memory = calloc(1, sizeof(RadixTelemetryPage));
+    return memory ? new (memory) RadixTelemetryPage() : nullptr;
+}
+
+bool RadixTelemetryStart(const char *name)
+{
+    static bool shared = false;
+    if (!gPage)
+    {
+        gName = name && *name ? name : "/radix-telemetry." + std::to_string(getpid());
+        RadixTelemetryPage *page = mapPage(gName, shared);
+        if (!page)
+            return false;
+
+        memcpy(page->magic, "RDXTELEM", 8);
+        page->version = kRadixTelemetryVersion;
+        page->slotCount = kRadixTelemetrySlots;
+        page->pid = uint64_t(getpid());
+        page->ticksPerNs = calibrateTicks();
+        gPage = page;
+        if (shared)
+            atexit(removeName);
+        else
+            gName.clear();
+    }
+    gEnabled.store(true, std::memory_order_release);
+    return shared;
+}
+
+void RadixTelemetryStop()
+{
+    gEnabled.store(false, std::memory_order_release);
+}
+
+const RadixTelemetryPage *RadixTelemetryGet()
+{
+    return gPage;
+}
+
+const char *RadixTelemetryName()
+{
+    return gName.c_str();
+}
+
+bool RadixTelemetryEnabled()
+{
+    return gEnabled.load(std::memory_order_relaxed);
+}
+
+// the first free slot, or a fresh one; nullptr if all are held
+static RadixTelemetrySlot *claimSlot()
+{
+    for (;;)
+    {
+        uint32_t used = gPage->slotsUsed.load(std::memory_order_relaxed);
+        for (uint32_t s = 0; s < used && s < kRadixTelemetrySlots; ++s)
+        {
+            uint32_t free = 0;
+            if (gPage->slots[s].owned.load(std::memory_order_relaxed) == 0 &&
+                gPage->slots[s].owned.compare_exchange_strong(free, 1, std::memory_order_acquire))
+                return &gPage->slots[s];
+        }
+        if (used >= kRadixTelemetrySlots)
+            return nullptr;
+
+        // a fresh slot can still be taken by a thread scanning past the new count, so claim it the same way
+        uint32_t index = gPage->slotsUsed.fetch_add(1, std::memory_order_relaxed);
+        uint32_t free = 0;
+        if (index < kRadixTelemetrySlots &&
+            gPage->slots[index].owned.compare_exchange_strong(free, 1, std::memory_order_acquire))
+            return &gPage->slots[index];
+    }
+}
+
+// a thread's hold on its slot, released when the thread exits
+struct SlotOwner
+{
+    RadixTelemetrySlot *slot = nullptr;
+    bool full = false; // every slot was held when the thread first counted
+
+    ~SlotOwner()
+    {
+        if (slot)
+            slot->owned.store(0, std::memory_order_release);
+    }
+};
+
+RadixTelemetrySlot *RadixTelemetryThreadSlot()
+{
+    static thread_local SlotOwner owner;
+    if (owner.slot || owner.full)
+    {
+        if (owner.full)
+            gPage->unslottedCalls.fetch_add(1, std::memory_order_relaxed);
+        return owner.slot;
+    }
+
+    owner.slot = claimSlot();
+    if (!owner.slot)
+    {
+        owner.full = true;
+        gPage->unslottedCalls.fetch_add(1, std::memory_order_relaxed);
+        return nullptr;
+    }
+    owner.slot->threadId.store(osThreadId(), std::memory_order_relaxed);
+    owner.slot->owners.fetch_add(1, std::memory_order_relaxed);
+    return owner.slot;
+}
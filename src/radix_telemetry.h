@@ -0,0 +1,126 @@
+#pragma once
+
+#include <stdint.h>
+
+#include <atomic>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define RADIX_TELEMETRY_TSC 1
+#elif defined(_M_X64) || defined(_M_IX86)
+#include <intrin.h>
+#define RADIX_TELEMETRY_TSC 1
+#else
+#include <chrono>
+#define RADIX_TELEMETRY_TSC 0
+#endif
+
+// Production counters for the radix engines: once RadixTelemetryStart runs, every RadixSort,
+// RadixSortKeys and RadixSort11 call adds to its thread's slot in a page of shared memory, which
+// another process (radix-stat) can map and read while this one keeps running. Each thread writes
+// only its own cache-line-aligned slot, with plain loads and stores, so counting needs no locked
+// instructions and threads never share a line. Reading the clock costs more than the counting (two
+// rdtsc can reach 50 ns in a VM, against 3 us for a 64-key sort), so calls below
+// kRadixTelemetryTimedElements are timed only 1 in kRadixTelemetrySampling, each timed one standing
+// for that many. Before RadixTelemetryStart, a call pays one relaxed atomic load. A thread holds its
+// slot until it exits; the next thread to claim the slot keeps adding to the same counters, so the
+// totals still cover every call while thread pools come and go.
+
+// The way the planner sorted a call.
+enum RadixPath : uint8_t
+{
+    kRadixPathInsertion, // below RadixTuning::smallSortThreshold
+    kRadixPath8,         // 8-bit digits
+    kRadixPath11,        // 11-bit digits (and RadixSort11)
+    kRadixPath16,        // 16-bit digits
+    kRadixPathParallel,  // any width, split across threads
+    kRadixPathCount,
+};
+
+static const uint32_t kRadixTelemetrySlots = 256;
+static const uint32_t kRadixTelemetryVersion = 2;
+static const uint32_t kRadixTelemetryTimedElements = 16384; // calls this large are always timed
+static const uint32_t kRadixTelemetrySampling = 16;         // smaller ones, 1 in this many
+
+// The totals of the threads that have held this slot, the current owner's included. Only the owner
+// writes them.
+struct alignas(64) RadixTelemetrySlot
+{
+    std::atomic<uint64_t> calls;
+    std::atomic<uint64_t> elements;
+    std::atomic<uint64_t> bytes; // elements times the key size
+    std::atomic<uint64_t> ticks; // time spent in the calls (sampled), RadixTelemetryPage::ticksPerNs per ns
+    std::atomic<uint64_t> paths[kRadixPathCount]; // calls by RadixPath
+    std::atomic<uint64_t> threadId;               // OS thread id of the latest owner
+    std::atomic<uint32_t> owned;                  // 1 while a live thread holds the slot
+    std::atomic<uint32_t> owners;                 // threads that have held it
+};
+
+// The shared page, laid out the same in every process of one build.
+struct RadixTelemetryPage
+{
+    char magic[8]; // "RDXTELEM"
+    uint32_t version;
+    uint32_t slotCount;
+    uint64_t pid;
+    double ticksPerNs;
+    std::atomic<uint32_t> slotsUsed;      // slots ever claimed (may overshoot slotCount)
+    std::atomic<uint64_t> unslottedCalls; // calls from threads that found every slot taken (not counted)
+    RadixTelemetrySlot slots[kRadixTelemetrySlots];
+};
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free, "telemetry atomics must work across processes");
+
+// Starts counting into a shared page named 'name' (POSIX shm, default "/radix-telemetry.<pid>"). The
+// name is removed when the process exits normally. Returns false if shared memory isn't available:
+// counting then goes to a private page that only RadixTelemetryGet can see. Calling it again just
+// resumes counting into the same page. Neither this nor RadixTelemetryStop is synchronized with
+// sorts running on other threads.
+bool RadixTelemetryStart(const char *name = nullptr);
+void RadixTelemetryStop();
+
+// The page and its shared-memory name (nullptr / empty before RadixTelemetryStart).
+const RadixTelemetryPage *RadixTelemetryGet();
+const char *RadixTelemetryName();
+
+// Used by the engines: whether counting is on, the calling thread's slot (nullptr if every slot was
+// held when the thread first counted; it then stays uncounted), and the clock the slots count in.
+// The slot is given back when the thread exits.
+bool RadixTelemetryEnabled();
+RadixTelemetrySlot *RadixTelemetryThreadSlot();
+
+inline uint64_t RadixTelemetryTicks()
+{
+#if RADIX_TELEMETRY_TSC
+    return __rdtsc();
+#else
+    return uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                        std::chrono::steady_clock::now().time_since_epoch())
+                        .count());
+#endif
+}
+
+// How many calls the next one on 'slot' stands for if it is timed; 0 if it isn't. Small calls are
+// picked by the golden-ratio sequence of the call count: 1 in kRadixTelemetrySampling, spread evenly
+// without locking onto any period in the caller's pattern of sizes.
+inline uint64_t RadixTelemetryWeight(const RadixTelemetrySlot *slot, uint32_t elements)
+{
+    if (elements >= kRadixTelemetryTimedElements)
+        return 1;
+    uint64_t call = slot->calls.load(std::memory_order_relaxed);
+    return (call * 0x9e3779b97f4a7c15ull) >> 60 == 0 ? kRadixTelemetrySampling : 0;
+}
+
+// Adds one finished call to 'slot'; 'ticks' is its time times its weight.
+inline void RadixTelemetryCount(RadixTelemetrySlot *slot, uint32_t elements, uint32_t keyBytes, RadixPath path,
+                                uint64_t ticks)
+{
+    auto add = [](std::atomic<uint64_t> &counter, uint64_t value) {
+        counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+    };
+    add(slot->calls, 1);
+    add(slot->elements, elements);
+    add(slot->bytes, uint64_t(elements) * keyBytes);
+    add(slot->ticks, ticks);
+    add(slot->paths[path], 1);
+}
@@ -0,0 +1,139 @@
+// radix_timeline.cpp: phase timeline of the parallel radix sort, written as Chrome trace JSON
+
+#include "radix_timeline.h"
+
+#include <stdio.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <utility>
+
+#if defined(__linux__)
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+static const char *kPhaseNames[] = {"sort", "histogram", "prefix sum", "scatter", "idle"};
+
+static std::atomic<bool> gEnabled{false};
+static std::atomic<uint64_t> gNext{0}; // events claimed, including dropped ones
+static std::atomic<uint32_t> gCalls{0};
+static std::unique_ptr<RadixPhaseEvent[]> gEvents;
+static std::unique_ptr<std::atomic<bool>[]> gReady; // event i is written
+static uint64_t gCapacity = 0;
+static std::chrono::steady_clock::time_point gEpoch;
+
+void RadixTimelineStart(uint32_t capacity)
+{
+    gEnabled.store(false, std::memory_order_relaxed);
+    gEvents.reset(new RadixPhaseEvent[capacity]);
+    gReady.reset(new std::atomic<bool>[capacity]);
+    for (uint32_t i = 0; i < capacity; ++i)
+        gReady[i].store(false, std::memory_order_relaxed);
+    gCapacity = capacity;
+    gNext.store(0, std::memory_order_relaxed);
+    gCalls.store(0, std::memory_order_relaxed);
+    gEpoch = std::chrono::steady_clock::now();
+    gEnabled.store(true, std::memory_order_release);
+}
+
+void RadixTimelineStop()
+{
+    gEnabled.store(false, std::memory_order_release);
+}
+
+bool RadixTimelineEnabled()
+{
+    return gEnabled.load(std::memory_order_relaxed);
+}
+
+uint64_t RadixTimelineNow()
+{
+    return uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - gEpoch)
+                        .count());
+}
+
+uint32_t RadixTimelineNextCall()
+{
+    return gCalls.fetch_add(1, std::memory_order_relaxed);
+}
+
+uint32_t RadixTimelineThreadId()
+{
+#if defined(__linux__)
+    static thread_local uint32_t id = uint32_t(syscall(SYS_gettid));
+#else
+    static thread_local uint32_t id = uint32_t(std::hash<std::thread::id>()(std::this_thread::get_id()));
+#endif
+    return id;
+}
+
+void RadixTimelineRecord(const RadixPhaseEvent &event)
+{
+    uint64_t index = gNext.fetch_add(1, std::memory_order_relaxed);
+    if (index >= gCapacity)
+        return;
+    gEvents[index] = event;
+    gReady[index].store(true, std::memory_order_release);
+}
+
+std::vector<RadixPhaseEvent> RadixTimelineSnapshot(uint64_t *dropped)
+{
+    uint64_t claimed = gNext.load(std::memory_order_acquire);
+    uint64_t count = claimed < gCapacity ? claimed : gCapacity;
+
+    std::vector<RadixPhaseEvent> events;
+    events.reserve(size_t(count));
+    for (uint64_t i = 0; i < count; ++i)
+    {
+        if (gReady[i].load(std::memory_order_acquire))
+            events.push_back(gEvents[i]);
+    }
+    if (dropped)
+        *dropped = claimed - events.size();
+    return events;
+}
+
+bool RadixTimelineWriteChrome(const char *path)
+{
+    std::vector<RadixPhaseEvent> events = RadixTimelineSnapshot();
+    FILE *f = fopen(path, "w");
+    if (!f)
+        return false;
+
+    // lane names first, each from the worker the thread first ran as, then the phases; timestamps are
+    // microseconds
+    std::vector<std::pair<uint32_t, uint32_t>> lanes; // thread, worker
+    for (const RadixPhaseEvent &e : events)
+        lanes.emplace_back(e.thread, e.worker);
+    std::stable_sort(lanes.begin(), lanes.end(),
+                     [](const auto &a, const auto &b) { return a.first < b.first; });
+    lanes.erase(std::unique(lanes.begin(), lanes.end(),
+                            [](const auto &a, const auto &b) { return a.first == b.first; }),
+                lanes.end());
+
+    fprintf(f, "{\"displayTimeUnit\": \"ns\", \"traceEvents\": [");
+    const char *separator = "\n";
+    for (const auto &lane : lanes)
+    {
+        fprintf(f, "%s{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": %u, \"args\": {\"name\": "
+                   "\"radix worker %u (thread %u)\"}}",
+                separator, lane.first, lane.second, lane.first);
+        separator = ",\n";
+    }
+    for (const RadixPhaseEvent &e : events)
+    {
+        fprintf(f,
+                "%s{\"name\": \"%s\", \"cat\": \"radix\", \"ph\": \"X\", \"ts\": %.3f, \"dur\": %.3f, \"pid\": 1, "
+                "\"tid\": %u, \"args\": {\"call\": %u, \"worker\": %u, \"elements\": %u, \"pass\": %u}}",
+                separator, kPhaseNames[int(e.phase)], e.beginNs / 1e3, (e.endNs - e.beginNs) / 1e3, e.thread,
+                e.call, unsigned(e.worker), e.elements, unsigned(e.pass));
+        separator = ",\n";
+    }
+    fprintf(f, "\n]}\n");
+    return fclose(f) == 0;
+}
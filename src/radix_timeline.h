@@ -0,0 +1,56 @@
+#pragma once
+
+#include <stdint.h>
+
+#include <vector>
+
+// Per-thread phase timeline of the parallel radix sort (RadixOptions::threads), for finding load
+// imbalance: while it runs, every worker of every parallel call records when it histogrammed its
+// chunk, summed offsets, scattered, and sat idle (waiting at a pass barrier, for its thread to
+// start, or for the others to finish). RadixTimelineWriteChrome turns the events into Chrome
+// trace-event JSON for Perfetto or chrome://tracing. Off, a parallel call checks one relaxed atomic
+// and each phase boundary tests a local flag.
+
+enum class RadixPhase : uint8_t
+{
+    Sort,      // the whole call, on worker 0's lane
+    Histogram, // counting this worker's chunk
+    PrefixSum, // bucket offsets from every worker's counts
+    Scatter,   // moving the chunk to its buckets
+    Idle,      // barrier waits, thread start-up and join
+};
+
+// One phase of one worker, in steady_clock nanoseconds since RadixTimelineStart.
+struct RadixPhaseEvent
+{
+    uint64_t beginNs = 0;
+    uint64_t endNs = 0;
+    uint32_t call = 0;     // parallel calls numbered from 0
+    uint32_t elements = 0; // the call's size
+    uint32_t thread = 0;   // OS thread that ran the phase
+    uint16_t worker = 0;   // 0 is the calling thread
+    uint8_t pass = 0;      // digit pass (Sort and Idle outside the passes: 0)
+    RadixPhase phase = RadixPhase::Sort;
+};
+
+// Starts recording into room for 'capacity' events; once full, later events are dropped and
+// counted. Neither this nor RadixTimelineStop is synchronized with sorts running on other threads.
+void RadixTimelineStart(uint32_t capacity = 1u << 20);
+void RadixTimelineStop();
+bool RadixTimelineEnabled();
+
+// The events recorded so far, in the order their phases ended; 'dropped' (if given) gets the number
+// that didn't fit.
+std::vector<RadixPhaseEvent> RadixTimelineSnapshot(uint64_t *dropped = nullptr);
+
+// {"traceEvents": [...]}: one complete ("X") event per phase, one lane (tid) per OS thread, so calls
+// running at once on different threads never share a lane; the call, worker and pass are in each
+// event's args. Returns false if the file can't be written.
+bool RadixTimelineWriteChrome(const char *path);
+
+// Used by the engines: nanoseconds since RadixTimelineStart, a number for a new call, the calling
+// thread's id for RadixPhaseEvent::thread, and adding one finished phase.
+uint64_t RadixTimelineNow();
+uint32_t RadixTimelineNextCall();
+uint32_t RadixTimelineThreadId();
+void RadixTimelineRecord(const RadixPhaseEvent &event);
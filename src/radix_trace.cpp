@@ -0,0 +1,161 @@
+// radix_trace.cpp: lock-free call tracer for the radix engines
+
+#include "radix_trace.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+
+static const char kMagic[8] = {'R', 'D', 'X', 'T', 'R', 'A', 'C', 'E'};
+static const uint32_t kVersion = 1;
+
+// File header, 32 bytes.
+struct TraceHeader
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t recordBytes;
+    uint64_t records;
+    uint64_t dropped;
+};
+
+// ------------------------------------------------------------------------------------------------
+// Ring
+
+// A slot's sequence is odd while a writer fills it and 2 * (ticket + 1) once ticket's record is in,
+// so a reader can tell a finished record from a torn or overwritten one.
+struct TraceSlot
+{
+    std::atomic<uint64_t> sequence{0};
+    RadixTraceRecord record;
+};
+
+static std::atomic<bool> gEnabled{false};
+static std::atomic<uint64_t> gHead{0}; // tickets handed out since RadixTraceStart
+static std::unique_ptr<TraceSlot[]> gSlots;
+static uint64_t gMask = 0;
+static std::chrono::steady_clock::time_point gEpoch;
+
+void RadixTraceStart(uint32_t capacity)
+{
+    uint64_t slots = 1;
+    while (slots < capacity)
+        slots <<= 1;
+
+    gEnabled.store(false, std::memory_order_relaxed);
+    gSlots.reset(new TraceSlot[slots]);
+    gMask = slots - 1;
+    gHead.store(0, std::memory_order_relaxed);
+    gEpoch = std::chrono::steady_clock::now();
+    gEnabled.store(true, std::memory_order_release);
+}
+
+void RadixTraceStop()
+{
+    gEnabled.store(false, std::memory_order_release);
+}
+
+bool RadixTraceEnabled()
+{
+    return gEnabled.load(std::memory_order_relaxed);
+}
+
+uint64_t RadixTraceNow()
+{
+    return uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - gEpoch)
+                        .count());
+}
+
+void RadixTraceAppend(const RadixTraceRecord &record)
+{
+    if (!gEnabled.load(std::memory_order_acquire))
+        return;
+
+    uint64_t ticket = gHead.fetch_add(1, std::memory_order_relaxed);
+    TraceSlot &slot = gSlots[ticket & gMask];
+    slot.sequence.store(2 * ticket + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    slot.record = record;
+    slot.sequence.store(2 * ticket + 2, std::memory_order_release);
+}
+
+std::vector<RadixTraceRecord> RadixTraceSnapshot(uint64_t *dropped)
+{
+    std::vector<RadixTraceRecord> records;
+    uint64_t head = gSlots ? gHead.load(std::memory_order_acquire) : 0;
+    uint64_t first = head > gMask + 1 ? head - (gMask + 1) : 0;
+    records.reserve(size_t(head - first));
+
+    for (uint64_t ticket = first; ticket < head; ++ticket)
+    {
+        TraceSlot &slot = gSlots[ticket & gMask];
+        uint64_t sequence = slot.sequence.load(std::memory_order_acquire);
+        if (sequence != 2 * ticket + 2)
+            continue;
+        RadixTraceRecord record = slot.record;
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (slot.sequence.load(std::memory_order_relaxed) == sequence)
+            records.push_back(record);
+    }
+
+    if (dropped)
+        *dropped = head - records.size();
+    return records;
+}
+
+// ------------------------------------------------------------------------------------------------
+// Dump files
+
+bool RadixTraceDump(const char *path)
+{
+    uint64_t dropped = 0;
+    std::vector<RadixTraceRecord> records = RadixTraceSnapshot(&dropped);
+
+    FILE *f = fopen(path, "wb");
+    if (!f)
+        return false;
+
+    TraceHeader header;
+    memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version = kVersion;
+    header.recordBytes = sizeof(RadixTraceRecord);
+    header.records = records.size();
+    header.dropped = dropped;
+
+    bool ok = fwrite(&header, sizeof(header), 1, f) == 1 &&
+              (records.empty() ||
+               fwrite(records.data(), sizeof(RadixTraceRecord), records.size(), f) == records.size());
+    return fclose(f) == 0 && ok;
+}
+
+bool RadixTraceLoad(const char *path, std::vector<RadixTraceRecord> &records, uint64_t *dropped)
+{
+    FILE *f = fopen(path, "rb");
+    if (!f)
+        return false;
+
+    TraceHeader header;
+    bool ok = fread(&header, sizeof(header), 1, f) == 1 && memcmp(header.magic, kMagic, sizeof(kMagic)) == 0 &&
+              header.version == kVersion && header.recordBytes == sizeof(RadixTraceRecord);
+    if (ok)
+    {
+        // the header's count must match what the file holds before anything is allocated for it
+        long start = ftell(f);
+        ok = start >= 0 && fseek(f, 0, SEEK_END) == 0;
+        long end = ok ? ftell(f) : -1;
+        ok = ok && end >= start && fseek(f, start, SEEK_SET) == 0 &&
+             header.records == uint64_t(end - start) / sizeof(RadixTraceRecord);
+    }
+    if (ok)
+    {
+        records.resize(size_t(header.records));
+        ok = records.empty() || fread(records.data(), sizeof(RadixTraceRecord), records.size(), f) == records.size();
+        if (ok && dropped)
+            *dropped = header.dropped;
+    }
+    fclose(f);
+    return ok;
+}
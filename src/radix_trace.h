@@ -0,0 +1,61 @@
+#pragma once
+
+#include <stdint.h>
+
+#include <vector>
+
+// Call tracer for the radix engines: while it runs, every RadixSortKeys (and so RadixSort) and
+// RadixSort11 call adds its size, key type, an estimate of how presorted its keys were and its
+// duration to a fixed ring of records. Recording takes no locks, so concurrent sorts can trace;
+// once the ring is full the oldest records are overwritten. Off, it costs each call one relaxed
+// atomic load. 'sort-bench --mode=replay' plays a dumped trace back against any engine.
+
+// Key type of a traced call (the engines.h key-type bit order).
+enum class RadixTraceKey : uint8_t
+{
+    F32,
+    F64,
+    I32,
+    U32,
+    I64,
+    U64,
+};
+
+enum : uint8_t
+{
+    kRadixTraceInPlace = 1, // RadixOptions::resultInPlace
+    kRadixTraceStream = 2,  // RadixOptions::streamFinalPass
+};
+
+// One call, exactly as stored in a dump file (host byte order).
+struct RadixTraceRecord
+{
+    uint64_t startNs = 0;    // steady_clock, since RadixTraceStart
+    uint64_t durationNs = 0; // planning and sorting; not the presortedness estimate
+    uint32_t elements = 0;
+    uint8_t keyType = 0;     // RadixTraceKey
+    uint8_t ascending = 0;   // share of sampled neighbour pairs already in order, 0..255
+    uint8_t threads = 0;     // threads the call's plan allowed
+    uint8_t flags = 0;       // kRadixTrace*
+};
+
+static_assert(sizeof(RadixTraceRecord) == 24, "RadixTraceRecord is the dump file layout");
+
+// Starts tracing into a fresh ring of 'capacity' records (rounded up to a power of two). Neither
+// this nor RadixTraceStop is synchronized with sorts running on other threads.
+void RadixTraceStart(uint32_t capacity = 1u << 20);
+void RadixTraceStop();
+bool RadixTraceEnabled();
+
+// The records in the ring, oldest first; 'dropped' (if given) gets the number of calls recorded
+// since RadixTraceStart that were overwritten or still being written.
+std::vector<RadixTraceRecord> RadixTraceSnapshot(uint64_t *dropped = nullptr);
+
+// Binary dump: a 32-byte header ("RDXTRACE", version, record size, record count, dropped count),
+// then the records. Both return false on I/O or format errors.
+bool RadixTraceDump(const char *path);
+bool RadixTraceLoad(const char *path, std::vector<RadixTraceRecord> &records, uint64_t *dropped = nullptr);
+
+// Used by the engines: nanoseconds since RadixTraceStart, and adding one finished call.
+uint64_t RadixTraceNow();
+void RadixTraceAppend(const RadixTraceRecord &record);
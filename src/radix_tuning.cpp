@@ -0,0 +1,136 @@
+// radix_tuning.cpp: per-machine tuning profile for the radix engines
+
+#include "radix_tuning.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static const char *kHintNames[] = {"t0", "t1", "t2", "nta"};
+
+// ------------------------------------------------------------------------------------------------
+// Active profile
+
+static RadixTuning &activeTuning()
+{
+    static RadixTuning tuning = RadixDefaultTuning();
+    return tuning;
+}
+
+RadixTuning RadixDefaultTuning()
+{
+    RadixTuning tuning;
+    RadixTuningEntry entry;
+#if defined(PREFETCH) && PREFETCH
+    entry.prefetch.srcDistance = 128;
+#endif
+    tuning.entries.push_back(entry);
+    return tuning;
+}
+
+const RadixTuning &RadixGetTuning()
+{
+    return activeTuning();
+}
+
+void RadixSetTuning(const RadixTuning &tuning)
+{
+    activeTuning() = tuning.entries.empty() ? RadixDefaultTuning() : tuning;
+}
+
+const RadixTuningEntry &RadixLookupTuning(const RadixTuning &tuning, uint32_t elements)
+{
+    for (const RadixTuningEntry &entry : tuning.entries)
+    {
+        if (elements <= entry.maxElements)
+            return entry;
+    }
+    return tuning.entries.back();
+}
+
+// ------------------------------------------------------------------------------------------------
+// File format: one setting per line, '#' starts a comment
+//
+//   small_sort_threshold <elements>
+//   entry <max_elements> <digit_bits> <src_distance> <src_hint> <dst_distance> <dst_hint> <threads>
+
+static bool parseHint(const char *name, RadixPrefetchHint &hint)
+{
+    for (int h = 0; h < 4; ++h)
+    {
+        if (strcmp(name, kHintNames[h]) == 0)
+        {
+            hint = RadixPrefetchHint(h);
+            return true;
+        }
+    }
+    return false;
+}
+
+bool RadixLoadTuning(const char *path, RadixTuning &tuning)
+{
+    FILE *f = fopen(path, "r");
+    if (!f)
+        return false;
+
+    RadixTuning loaded;
+    bool ok = true;
+    char line[256];
+    while (ok && fgets(line, sizeof(line), f))
+    {
+        char *comment = strchr(line, '#');
+        if (comment)
+            *comment = '\0';
+
+        char key[32];
+        if (sscanf(line, "%31s", key) != 1)
+            continue; // blank line
+
+        if (strcmp(key, "small_sort_threshold") == 0)
+        {
+            ok = sscanf(line, "%*s %u", &loaded.smallSortThreshold) == 1;
+        }
+        else if (strcmp(key, "entry") == 0)
+        {
+            RadixTuningEntry entry;
+            char srcHint[8], dstHint[8];
+            ok = sscanf(line, "%*s %u %u %u %7s %u %7s %u", &entry.maxElements, &entry.digitBits,
+                        &entry.prefetch.srcDistance, srcHint, &entry.prefetch.dstDistance, dstHint,
+                        &entry.threads) == 7 &&
+                 parseHint(srcHint, entry.prefetch.srcHint) && parseHint(dstHint, entry.prefetch.dstHint) &&
+                 (entry.digitBits == 8 || entry.digitBits == 11 || entry.digitBits == 16) && entry.threads >= 1 &&
+                 (loaded.entries.empty() || entry.maxElements > loaded.entries.back().maxElements);
+            if (ok)
+                loaded.entries.push_back(entry);
+        }
+        else
+        {
+            ok = false;
+        }
+    }
+    fclose(f);
+
+    if (!ok || loaded.entries.empty())
+        return false;
+
+    tuning = loaded;
+    return true;
+}
+
+bool RadixSaveTuning(const char *path, const RadixTuning &tuning)
+{
+    FILE *f = fopen(path, "w");
+    if (!f)
+        return false;
+
+    fprintf(f, "# radix sort tuning profile\n");
+    fprintf(f, "small_sort_threshold %u\n", tuning.smallSortThreshold);
+    fprintf(f, "# max_elements digit_bits src_distance src_hint dst_distance dst_hint threads\n");
+    for (const RadixTuningEntry &e : tuning.entries)
+    {
+        fprintf(f, "entry %u %u %u %s %u %s %u\n", e.maxElements, e.digitBits, e.prefetch.srcDistance,
+                kHintNames[int(e.prefetch.srcHint)], e.prefetch.dstDistance, kHintNames[int(e.prefetch.dstHint)],
+                e.threads);
+    }
+    return fclose(f) == 0;
+}
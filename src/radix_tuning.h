@@ -0,0 +1,42 @@
+#pragma once
+
+#include <stdint.h>
+
+#include <vector>
+
+#include "radix.h"
+
+// Best settings for one size class of a tuning profile.
+struct RadixTuningEntry
+{
+    uint32_t maxElements = UINT32_MAX; // applies to calls of up to this many elements
+    uint32_t digitBits = 11;
+    RadixPrefetch prefetch;
+    uint32_t threads = 1;
+};
+
+// Per-machine tuning profile, written by 'sort-bench --mode=autotune'. Unset RadixOptions
+// tunables are looked up here on every call.
+struct RadixTuning
+{
+    uint32_t smallSortThreshold = 64;      // insertion sort below this many elements
+    std::vector<RadixTuningEntry> entries; // ascending maxElements; the last also covers larger calls
+};
+
+// Compiled defaults: 11-bit digits, one thread, insertion sort below 64 elements, and a source
+// prefetch distance of 128 when built with ENABLE_PREFETCH.
+RadixTuning RadixDefaultTuning();
+
+// The active profile: the compiled defaults until RadixSetTuning replaces them. The library never
+// reads a profile on its own; load one with RadixLoadTuning. RadixSort11 ignores it.
+const RadixTuning &RadixGetTuning();
+
+// Replaces the active profile. Not synchronized with sorts running on other threads.
+void RadixSetTuning(const RadixTuning &tuning);
+
+// The entry covering calls of 'elements' elements.
+const RadixTuningEntry &RadixLookupTuning(const RadixTuning &tuning, uint32_t elements);
+
+// Text profile I/O; both return false (leaving 'tuning' untouched on load) on failure.
+bool RadixLoadTuning(const char *path, RadixTuning &tuning);
+bool RadixSaveTuning(const char *path, const RadixTuning &tuning);
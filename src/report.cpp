@@ -0,0 +1,398 @@
+// report.cpp
+// Machine-readable benchmark results.
+
+#include "report.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <thread>
+
+#include "build_info.h"
+#include "sysinfo.h"
+
+BenchMetadata collectMetadata()
+{
+    BenchMetadata meta;
+    meta.emplace_back("compiler", SORT_BENCH_COMPILER);
+    meta.emplace_back("build_type", SORT_BENCH_CONFIG);
+    meta.emplace_back("cxx_flags", SORT_BENCH_CXX_FLAGS);
+    meta.emplace_back("opt_flags", std::string(SORT_BENCH_CONFIG) == "Debug" ? "" : SORT_BENCH_OPT_FLAGS);
+    meta.emplace_back("ENABLE_PREFETCH", PREFETCH ? "ON" : "OFF");
+    meta.emplace_back("ENABLE_RADIX_STATS", RADIX_STATS ? "ON" : "OFF");
+    meta.emplace_back("git_rev", SORT_BENCH_GIT_REV);
+    meta.emplace_back("cpu_model", cpuModel());
+    meta.emplace_back("caches", cacheSizes());
+    meta.emplace_back("logical_cpus", std::to_string(std::thread::hardware_concurrency()));
+    meta.emplace_back("kernel", kernelVersion());
+    return meta;
+}
+
+// 'value' as a JSON string literal
+static std::string jsonString(const std::string &value)
+{
+    std::ostringstream out;
+    out << '"';
+    for (char c : value)
+    {
+        if (c == '"' || c == '\\')
+            out << '\\' << c;
+        else if (uint8_t(c) < 0x20)
+            out << "\\u" << std::hex << std::setw(4) << std::setfill('0') << int(c) << std::dec << std::setfill(' ');
+        else
+            out << c;
+    }
+    out << '"';
+    return out.str();
+}
+
+// 'value' as a JSON number, or null if it is infinite or NaN, which JSON has no literal for. Tested
+// on the bits: under -ffast-math, std::isfinite may fold to true.
+static void writeJsonNumber(std::ostream &out, double value)
+{
+    uint64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    if ((bits >> 52 & 0x7ff) == 0x7ff)
+        out << "null";
+    else
+        out << value;
+}
+
+// 'value' as a CSV field, quoted only when it needs to be
+static std::string csvField(const std::string &value)
+{
+    if (value.find_first_of(",\"\n") == std::string::npos)
+        return value;
+    std::string out = "\"";
+    for (char c : value)
+    {
+        if (c == '"')
+            out += '"';
+        out += c;
+    }
+    return out + "\"";
+}
+
+// counters present in at least one record, so every row has the same columns
+static std::vector<int> countersUsed(const std::vector<BenchRecord> &records)
+{
+    std::vector<int> used;
+    for (int c = 0; c < kPerfEventCount; ++c)
+    {
+        for (const BenchRecord &r : records)
+        {
+            if (r.counters.valid[c])
+            {
+                used.push_back(c);
+                break;
+            }
+        }
+    }
+    return used;
+}
+
+void writeJson(std::ostream &out, const BenchMetadata &meta, const std::vector<BenchRecord> &records)
+{
+    out << std::defaultfloat << std::setprecision(9);
+    out << "{\n  \"metadata\": {";
+    for (size_t i = 0; i < meta.size(); ++i)
+        out << (i ? "," : "") << "\n    " << jsonString(meta[i].first) << ": " << jsonString(meta[i].second);
+    out << "\n  },\n  \"records\": [";
+
+    for (size_t i = 0; i < records.size(); ++i)
+    {
+        const BenchRecord &r = records[i];
+        out << (i ? "," : "") << "\n    {\"engine\": " << jsonString(r.engine)
+            << ", \"scenario\": " << jsonString(r.scenario) << ", \"elements\": " << r.elements
+            << ", \"trials\": " << r.trials << ", \"rep\": " << r.rep << ", \"seconds\": ";
+        writeJsonNumber(out, r.seconds);
+        out << ", \"melem_per_sec\": ";
+        writeJsonNumber(out, double(r.elements) * r.trials / r.seconds / 1e6);
+        for (int c = 0; c < kPerfEventCount; ++c)
+        {
+            if (r.counters.valid[c])
+            {
+                out << ", " << jsonString(PerfCounters::name(c)) << ": ";
+                writeJsonNumber(out, r.counters.value[c]);
+            }
+        }
+        if (r.memory.valid)
+            out << ", \"allocations\": " << r.memory.allocations << ", \"heap_peak_bytes\": " << r.memory.heapPeak
+                << ", \"stack_peak_bytes\": " << r.memory.stackPeak << ", \"rss_peak_bytes\": " << r.memory.rssPeak;
+        out << "}";
+    }
+    out << "\n  ]\n}\n";
+}
+
+void writeCsv(std::ostream &out, const BenchMetadata &meta, const std::vector<BenchRecord> &records)
+{
+    for (const auto &kv : meta)
+        out << "# " << kv.first << ": " << kv.second << "\n";
+
+    std::vector<int> counters = countersUsed(records);
+    bool memory = std::any_of(records.begin(), records.end(), [](const BenchRecord &r) { return r.memory.valid; });
+    out << "engine,scenario,elements,trials,rep,seconds,melem_per_sec";
+    for (int c : counters)
+        out << "," << PerfCounters::name(c);
+    if (memory)
+        out << ",allocations,heap_peak_bytes,stack_peak_bytes,rss_peak_bytes";
+    out << "\n";
+
+    out << std::defaultfloat << std::setprecision(9);
+    for (const BenchRecord &r : records)
+    {
+        out << csvField(r.engine) << "," << csvField(r.scenario) << "," << r.elements << "," << r.trials << ","
+            << r.rep << "," << r.seconds << "," << double(r.elements) * r.trials / r.seconds / 1e6;
+        for (int c : counters)
+        {
+            out << ",";
+            if (r.counters.valid[c])
+                out << r.counters.value[c];
+        }
+        if (memory && r.memory.valid)
+            out << "," << r.memory.allocations << "," << r.memory.heapPeak << "," << r.memory.stackPeak << ","
+                << r.memory.rssPeak;
+        else if (memory)
+            out << ",,,,";
+        out << "\n";
+    }
+}
+
+
+// Just enough of a JSON reader for our own files: objects, arrays, strings and numbers (true, false
+// and null are skipped as bare words). Each parse function returns false on malformed input.
+class JsonReader
+{
+  public:
+    explicit JsonReader(const std::string &text) : p_(text.c_str()) {}
+
+    bool peek(char c)
+    {
+        skipSpace();
+        return *p_ == c;
+    }
+
+    bool expect(char c)
+    {
+        skipSpace();
+        if (*p_ != c)
+            return false;
+        ++p_;
+        return true;
+    }
+
+    bool string(std::string &out)
+    {
+        if (!expect('"'))
+            return false;
+        out.clear();
+        for (; *p_ && *p_ != '"'; ++p_)
+        {
+            if (*p_ != '\\')
+            {
+                out += *p_;
+                continue;
+            }
+            ++p_;
+            if (*p_ == 'u')
+            {
+                char hex[5] = {};
+                for (int i = 0; i < 4 && p_[1]; ++i)
+                    hex[i] = *++p_;
+                out += char(std::strtoul(hex, nullptr, 16)); // only control characters are escaped
+            }
+            else if (*p_)
+                out += *p_ == 'n' ? '\n' : *p_ == 't' ? '\t' : *p_;
+        }
+        return expect('"');
+    }
+
+    bool number(double &out)
+    {
+        skipSpace();
+        char *end;
+        out = std::strtod(p_, &end);
+        if (end == p_)
+            return false;
+        p_ = end;
+        return true;
+    }
+
+    // a null in place of a number (writeJsonNumber's infinities and NaNs)
+    bool null()
+    {
+        skipSpace();
+        if (std::strncmp(p_, "null", 4) != 0)
+            return false;
+        p_ += 4;
+        return true;
+    }
+
+    // any value, as text (strings unquoted)
+    bool scalar(std::string &out)
+    {
+        if (peek('"'))
+            return string(out);
+        const char *start = p_;
+        while (*p_ && !std::strchr(",}] \t\r\n", *p_))
+            ++p_;
+        out.assign(start, p_);
+        return p_ != start;
+    }
+
+    bool skipValue()
+    {
+        if (peek('{') || peek('['))
+        {
+            char close = *p_ == '{' ? '}' : ']';
+            bool object = close == '}';
+            ++p_;
+            if (expect(close))
+                return true;
+            do
+            {
+                std::string key;
+                if (object && !(string(key) && expect(':')))
+                    return false;
+                if (!skipValue())
+                    return false;
+            } while (expect(','));
+            return expect(close);
+        }
+        std::string ignored;
+        return scalar(ignored);
+    }
+
+  private:
+    void skipSpace()
+    {
+        while (*p_ == ' ' || *p_ == '\t' || *p_ == '\r' || *p_ == '\n')
+            ++p_;
+    }
+
+    const char *p_;
+};
+
+static bool readRecord(JsonReader &in, BenchRecord &r)
+{
+    if (!in.expect('{'))
+        return false;
+    if (in.expect('}'))
+        return true;
+    do
+    {
+        std::string key;
+        if (!in.string(key) || !in.expect(':'))
+            return false;
+
+        double value = 0;
+        int counter = -1;
+        for (int c = 0; c < kPerfEventCount; ++c)
+        {
+            if (key == PerfCounters::name(c))
+                counter = c;
+        }
+
+        bool ok;
+        if (key == "engine")
+            ok = in.string(r.engine);
+        else if (key == "scenario")
+            ok = in.string(r.scenario);
+        else if ((key == "seconds" || counter >= 0) && in.null())
+            ok = true; // not a number when written: left unset
+        else if (key == "elements" || key == "trials" || key == "rep" || key == "seconds" || counter >= 0)
+        {
+            ok = in.number(value);
+            if (key == "elements")
+                r.elements = uint32_t(value);
+            else if (key == "trials")
+                r.trials = uint32_t(value);
+            else if (key == "rep")
+                r.rep = int(value);
+            else if (key == "seconds")
+                r.seconds = value;
+            else
+            {
+                r.counters.valid[counter] = true;
+                r.counters.value[counter] = value;
+            }
+        }
+        else
+            ok = in.skipValue();
+        if (!ok)
+            return false;
+    } while (in.expect(','));
+    return in.expect('}');
+}
+
+bool readJson(const std::string &path, BenchMetadata &meta, std::vector<BenchRecord> &records, std::string &error)
+{
+    std::ifstream f(path);
+    if (!f)
+    {
+        error = "cannot open " + path;
+        return false;
+    }
+    std::stringstream text;
+    text << f.rdbuf();
+    const std::string contents = text.str();
+
+    JsonReader in(contents);
+    meta.clear();
+    records.clear();
+    error = path + ": malformed JSON";
+
+    if (!in.expect('{'))
+        return false;
+    do
+    {
+        std::string key;
+        if (!in.string(key) || !in.expect(':'))
+            return false;
+
+        if (key == "metadata")
+        {
+            if (!in.expect('{'))
+                return false;
+            if (!in.expect('}'))
+            {
+                do
+                {
+                    std::pair<std::string, std::string> kv;
+                    if (!in.string(kv.first) || !in.expect(':') || !in.scalar(kv.second))
+                        return false;
+                    meta.push_back(kv);
+                } while (in.expect(','));
+                if (!in.expect('}'))
+                    return false;
+            }
+        }
+        else if (key == "records")
+        {
+            if (!in.expect('['))
+                return false;
+            if (!in.expect(']'))
+            {
+                do
+                {
+                    BenchRecord r;
+                    if (!readRecord(in, r))
+                        return false;
+                    records.push_back(r);
+                } while (in.expect(','));
+                if (!in.expect(']'))
+                    return false;
+            }
+        }
+        else if (!in.skipValue())
+            return false;
+    } while (in.expect(','));
+
+    if (!in.expect('}'))
+        return false;
+    error.clear();
+    return true;
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+// Machine-readable benchmark results (--format=json|csv): one record per engine, scenario, size and
+// repetition, preceded by metadata describing the build and the machine.
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "memory_usage.h"
+#include "perf_counters.h"
+
+// One timed repetition.
+struct BenchRecord
+{
+    std::string engine;
+    std::string scenario;
+    uint32_t elements = 0;
+    uint32_t trials = 0; // sorts per repetition
+    int rep = 0;
+    double seconds = 0; // for all 'trials' sorts
+    PerfCounts counters; // totals for the repetition (--counters); missing counters are left out
+    MemoryUsage memory;  // over the repetition (--memory); left out when not measured
+};
+
+// Ordered key/value pairs.
+using BenchMetadata = std::vector<std::pair<std::string, std::string>>;
+
+// Build and host description: compiler and flags, CMake options, CPU model, caches, logical CPUs,
+// kernel and git revision.
+BenchMetadata collectMetadata();
+
+// {"metadata": {...}, "records": [{...}, ...]}, one record per line.
+void writeJson(std::ostream &out, const BenchMetadata &meta, const std::vector<BenchRecord> &records);
+
+// Reads back a file written by writeJson (other fields are skipped). Returns false, with the reason
+// in 'error', if the file can't be read or parsed.
+bool readJson(const std::string &path, BenchMetadata &meta, std::vector<BenchRecord> &records, std::string &error);
+
+// '# key: value' comment lines for the metadata, then a header row and one row per record.
+void writeCsv(std::ostream &out, const BenchMetadata &meta, const std::vector<BenchRecord> &records);
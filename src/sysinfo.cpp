@@ -0,0 +1,237 @@
+// sysinfo.cpp
+// Host environment queries for the benchmark.
+
+#include "sysinfo.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+
+#if defined(__linux__)
+#include <sched.h>
+#include <sys/utsname.h>
+#elif defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#endif
+
+// first line of a (sysfs) file, empty if it can't be read
+static std::string readLine(const std::string &path)
+{
+    std::ifstream f(path);
+    std::string line;
+    std::getline(f, line);
+    return line;
+}
+
+bool pinToCpu(int cpu)
+{
+    if (cpu < 0)
+        return false;
+#if defined(__linux__)
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    return sched_setaffinity(0, sizeof(set), &set) == 0;
+#elif defined(_WIN32)
+    return cpu < 64 && SetThreadAffinityMask(GetCurrentThread(), DWORD_PTR(1) << cpu) != 0;
+#else
+    return false;
+#endif
+}
+
+bool pinToCpus(const std::vector<int> &cpus)
+{
+    if (cpus.empty())
+        return false;
+#if defined(__linux__)
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (int cpu : cpus)
+        CPU_SET(cpu, &set);
+    return sched_setaffinity(0, sizeof(set), &set) == 0;
+#elif defined(_WIN32)
+    DWORD_PTR mask = 0;
+    for (int cpu : cpus)
+        mask |= cpu < 64 ? DWORD_PTR(1) << cpu : 0;
+    return mask && SetThreadAffinityMask(GetCurrentThread(), mask) != 0;
+#else
+    return false;
+#endif
+}
+
+std::vector<int> allowedCpus()
+{
+    std::vector<int> cpus;
+#if defined(__linux__)
+    cpu_set_t set;
+    if (sched_getaffinity(0, sizeof(set), &set) == 0)
+    {
+        for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu)
+        {
+            if (CPU_ISSET(cpu, &set))
+                cpus.push_back(cpu);
+        }
+    }
+#elif defined(_WIN32)
+    DWORD_PTR process, system;
+    if (GetProcessAffinityMask(GetCurrentProcess(), &process, &system))
+    {
+        for (int cpu = 0; cpu < 64; ++cpu)
+        {
+            if (process & (DWORD_PTR(1) << cpu))
+                cpus.push_back(cpu);
+        }
+    }
+#endif
+    return cpus;
+}
+
+std::vector<int> placementOrder(const std::vector<int> &cpus, bool spreadCores)
+{
+    // (core, SMT rank) of every CPU: cores numbered in order of first appearance
+    std::vector<std::string> cores;
+    std::vector<std::pair<int, int>> slots;
+    for (int cpu : cpus)
+    {
+        std::string dir = "/sys/devices/system/cpu/cpu" + std::to_string(cpu) + "/topology/";
+        std::string core = readLine(dir + "physical_package_id") + ":" + readLine(dir + "core_id");
+        if (core == ":")
+            return cpus;
+
+        int index = int(std::find(cores.begin(), cores.end(), core) - cores.begin());
+        if (index == int(cores.size()))
+            cores.push_back(core);
+        int rank = 0;
+        for (const auto &slot : slots)
+            rank += slot.first == index;
+        slots.emplace_back(index, rank);
+    }
+
+    std::vector<size_t> order(cpus.size());
+    for (size_t i = 0; i < order.size(); ++i)
+        order[i] = i;
+    auto key = [&](size_t i) { return spreadCores ? std::make_pair(slots[i].second, slots[i].first) : slots[i]; };
+    std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) { return key(a) < key(b); });
+
+    std::vector<int> out;
+    for (size_t i : order)
+        out.push_back(cpus[i]);
+    return out;
+}
+
+int currentCpu()
+{
+#if defined(__linux__)
+    return sched_getcpu();
+#elif defined(_WIN32)
+    return int(GetCurrentProcessorNumber());
+#else
+    return -1;
+#endif
+}
+
+std::string cpuGovernor(int cpu)
+{
+    if (cpu < 0)
+        return "";
+    return readLine("/sys/devices/system/cpu/cpu" + std::to_string(cpu) + "/cpufreq/scaling_governor");
+}
+
+int turboState()
+{
+    // intel_pstate reports the inverse, acpi-cpufreq / amd-pstate report 'boost'
+    std::string noTurbo = readLine("/sys/devices/system/cpu/intel_pstate/no_turbo");
+    if (!noTurbo.empty())
+        return noTurbo == "0" ? 1 : 0;
+
+    std::string boost = readLine("/sys/devices/system/cpu/cpufreq/boost");
+    if (!boost.empty())
+        return boost == "1" ? 1 : 0;
+
+    return -1;
+}
+
+void warnAboutNoise(int cpu)
+{
+    std::string governor = cpuGovernor(cpu);
+    int turbo = turboState();
+
+    std::cerr << "cpu " << cpu << ": governor " << (governor.empty() ? "unknown" : governor) << ", turbo "
+              << (turbo < 0 ? "unknown" : turbo ? "on" : "off") << "\n";
+
+    if (!governor.empty() && governor != "performance")
+        std::cerr << "warning: cpufreq governor '" << governor
+                  << "' scales the clock during the run; use 'performance' for stable results\n";
+    if (turbo == 1)
+        std::cerr << "warning: turbo boost is on; clock speed will vary with temperature and load\n";
+}
+
+std::string cpuModel()
+{
+    std::ifstream f("/proc/cpuinfo");
+    for (std::string line; std::getline(f, line);)
+    {
+        if (line.compare(0, 10, "model name") == 0)
+        {
+            size_t colon = line.find(':');
+            size_t start = colon == std::string::npos ? colon : line.find_first_not_of(" \t", colon + 1);
+            if (start != std::string::npos)
+                return line.substr(start);
+        }
+    }
+    return "";
+}
+
+std::string cacheSizes()
+{
+    std::string out;
+    for (int i = 0;; ++i)
+    {
+        std::string dir = "/sys/devices/system/cpu/cpu0/cache/index" + std::to_string(i) + "/";
+        std::string level = readLine(dir + "level");
+        if (level.empty())
+            break;
+
+        std::string type = readLine(dir + "type");
+        std::string suffix = type == "Data" ? "d" : type == "Instruction" ? "i" : "";
+        if (!out.empty())
+            out += ", ";
+        out += "L" + level + suffix + " " + readLine(dir + "size");
+    }
+    return out;
+}
+
+size_t lastLevelCacheBytes()
+{
+    size_t largest = 0;
+    for (int i = 0;; ++i)
+    {
+        std::string dir = "/sys/devices/system/cpu/cpu0/cache/index" + std::to_string(i) + "/";
+        std::string size = readLine(dir + "size");
+        if (size.empty())
+            break;
+
+        // "36864K", "2M"
+        char *end = nullptr;
+        size_t bytes = std::strtoul(size.c_str(), &end, 10);
+        if (*end == 'K')
+            bytes <<= 10;
+        else if (*end == 'M')
+            bytes <<= 20;
+        largest = std::max(largest, bytes);
+    }
+    return largest;
+}
+
+std::string kernelVersion()
+{
+#if defined(__linux__)
+    utsname u;
+    if (uname(&u) == 0)
+        return std::string(u.sysname) + " " + u.release;
+#endif
+    return "";
+}
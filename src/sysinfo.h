@@ -0,0 +1,52 @@
+#pragma once
+
+// Host environment queries for the benchmark: CPU pinning, sources of timing noise, and the
+// description of the machine that goes into machine-readable results.
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+// Pins the calling thread to logical CPU 'cpu'. On Linux the threads it creates from then on inherit
+// the pin, so pin before starting workers only if they should share the CPU. Returns false if the
+// platform refuses or does not support it.
+bool pinToCpu(int cpu);
+
+// Restricts the calling thread to the logical CPUs in 'cpus'. On Linux the threads it creates from
+// then on inherit the restriction; on Windows they don't (SetThreadAffinityMask is per thread). Threads
+// that already exist, such as a started TBB pool, keep their own. Returns false if the platform refuses
+// or does not support it.
+bool pinToCpus(const std::vector<int> &cpus);
+
+// Logical CPUs the calling thread may run on, in ascending order; empty if unknown.
+std::vector<int> allowedCpus();
+
+// 'cpus' in the order to hand them to threads. 'spreadCores' takes one logical CPU of every
+// physical core first, then the second SMT thread of each, and so on; otherwise the SMT siblings
+// of a core stay next to each other (compact). Unknown topology keeps the order as it is.
+std::vector<int> placementOrder(const std::vector<int> &cpus, bool spreadCores);
+
+// The logical CPU the calling thread is running on, or -1 if unknown.
+int currentCpu();
+
+// cpufreq scaling governor of 'cpu' ("performance", "powersave", ...), empty if unknown.
+std::string cpuGovernor(int cpu);
+
+// Turbo / boost state: 1 enabled, 0 disabled, -1 unknown.
+int turboState();
+
+// Prints the governor and turbo state of 'cpu' to stderr, with a warning for each setting that
+// adds run-to-run noise.
+void warnAboutNoise(int cpu);
+
+// CPU model name ("Intel(R) Core(TM) i7-...", ...), empty if unknown.
+std::string cpuModel();
+
+// Cache hierarchy of CPU 0, e.g. "L1d 48K, L1i 32K, L2 2048K, L3 36864K"; empty if unknown.
+std::string cacheSizes();
+
+// Size in bytes of the largest (last-level) cache CPU 0 sees, 0 if unknown.
+size_t lastLevelCacheBytes();
+
+// Kernel name and release ("Linux 6.8.0-45-generic"), empty if unknown.
+std::string kernelVersion();
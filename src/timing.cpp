@@ -0,0 +1,211 @@
+// timing.cpp
+// Repetition statistics for the benchmark.
+
+#include "timing.h"
+
+#include <algorithm>
+#include <cmath>
+#include <thread>
+
+double median(std::vector<double> &values)
+{
+    if (values.empty())
+        return 0.0;
+
+    std::sort(values.begin(), values.end());
+    size_t n = values.size();
+    return n & 1 ? values[n / 2] : 0.5 * (values[n / 2 - 1] + values[n / 2]);
+}
+
+// P(X <= k) for X ~ Binomial(n, 1/2)
+static double binomialCdfHalf(size_t n, size_t k)
+{
+    double term = std::pow(0.5, double(n)); // P(X = 0)
+    double cdf = term;
+    for (size_t i = 1; i <= k; ++i)
+    {
+        term *= double(n - i + 1) / double(i);
+        cdf += term;
+    }
+    return cdf;
+}
+
+SampleStats summarize(std::vector<double> samples, double confidence)
+{
+    SampleStats s;
+    s.count = samples.size();
+    if (samples.empty())
+        return s;
+
+    s.median = median(samples); // sorts 'samples'
+    s.min = samples.front();
+    s.max = samples.back();
+
+    std::vector<double> deviations;
+    deviations.reserve(samples.size());
+    for (double x : samples)
+        deviations.push_back(std::fabs(x - s.median));
+    s.mad = median(deviations);
+
+    // [x(j), x(n-1-j)] (0-based) covers the median with probability 1 - 2 P(X <= j), X ~ Bin(n, 1/2);
+    // take the narrowest such interval that still reaches 'confidence'
+    size_t n = samples.size();
+    s.ciLow = s.min;
+    s.ciHigh = s.max;
+    s.ciLevel = n > 1 ? 1.0 - 2.0 * binomialCdfHalf(n, 0) : 0.0;
+    for (size_t j = 1; 2 * j < n - 1; ++j)
+    {
+        double level = 1.0 - 2.0 * binomialCdfHalf(n, j);
+        if (level < confidence)
+            break;
+        s.ciLow = samples[j];
+        s.ciHigh = samples[n - 1 - j];
+        s.ciLevel = level;
+    }
+    return s;
+}
+
+double mannWhitneyGreater(const std::vector<double> &a, const std::vector<double> &b)
+{
+    size_t n = a.size(), m = b.size();
+    if (n == 0 || m == 0)
+        return 1.0;
+
+    double u = 0.0;
+    for (double x : a)
+    {
+        for (double y : b)
+            u += x > y ? 1.0 : x == y ? 0.5 : 0.0;
+    }
+
+    if (n * m > 400)
+    {
+        // normal approximation with continuity correction
+        double mean = 0.5 * double(n * m);
+        double sd = std::sqrt(double(n * m) * double(n + m + 1) / 12.0);
+        return 0.5 * std::erfc((u - 0.5 - mean) / sd / std::sqrt(2.0));
+    }
+
+    // exact null distribution: ways[i][j][k] = orderings of i a's and j b's with U = k, built up as
+    // ways[i][j] = ways[i-1][j] shifted by j (the last element is an a beating all j b's) + ways[i][j-1]
+    std::vector<std::vector<double>> prev(m + 1), cur(m + 1);
+    for (size_t j = 0; j <= m; ++j)
+        prev[j] = {1.0};
+    for (size_t i = 1; i <= n; ++i)
+    {
+        cur[0] = {1.0};
+        for (size_t j = 1; j <= m; ++j)
+        {
+            cur[j].assign(i * j + 1, 0.0);
+            for (size_t k = 0; k < prev[j].size(); ++k)
+                cur[j][k + j] += prev[j][k];
+            for (size_t k = 0; k < cur[j - 1].size(); ++k)
+                cur[j][k] += cur[j - 1][k];
+        }
+        std::swap(prev, cur);
+    }
+
+    // P(U >= u), rounding a tied half down (conservative)
+    const std::vector<double> &ways = prev[m];
+    double total = 0.0, tail = 0.0;
+    for (size_t k = 0; k < ways.size(); ++k)
+    {
+        total += ways[k];
+        if (double(k) >= std::floor(u))
+            tail += ways[k];
+    }
+    return tail / total;
+}
+
+CallTimer::CallTimer()
+{
+#if TIMING_RDTSCP
+    // ticks per ns over a ~20 ms steady_clock window
+    auto c0 = std::chrono::steady_clock::now();
+    uint64_t t0 = start();
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    uint64_t t1 = stop();
+    double elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - c0).count();
+    ticksPerNs_ = double(t1 - t0) / elapsed;
+#else
+    ticksPerNs_ = double(std::chrono::steady_clock::period::den) / std::chrono::steady_clock::period::num / 1e9;
+#endif
+
+    // overhead: the least of many empty intervals (the median would carry interrupts and misses)
+    uint64_t least = UINT64_MAX;
+    for (int i = 0; i < 1000; ++i)
+    {
+        uint64_t a = start();
+        uint64_t b = stop();
+        least = std::min(least, b - a);
+    }
+    overheadNs_ = double(least) / ticksPerNs_;
+}
+
+double CallTimer::ns(uint64_t begin, uint64_t end) const
+{
+    return std::max(0.0, double(end - begin) / ticksPerNs_ - overheadNs_);
+}
+
+// bucket of 'v': exact below 2^kSubBits, then 2^(kSubBits-1) buckets per power of two
+static size_t latencyBucket(uint64_t v, int subBits)
+{
+    const uint64_t exact = uint64_t(1) << subBits, half = exact >> 1;
+    if (v < exact)
+        return size_t(v);
+    int msb = 63;
+    while (!(v >> msb))
+        --msb;
+    int shift = msb - (subBits - 1); // v >> shift lies in [half, exact)
+    return size_t(exact + uint64_t(shift - 1) * half + ((v >> shift) - half));
+}
+
+// [low, high) of bucket 'i'
+static void latencyBucketRange(size_t i, int subBits, double &low, double &high)
+{
+    const uint64_t exact = uint64_t(1) << subBits, half = exact >> 1;
+    if (i < exact)
+    {
+        low = double(i);
+        high = low + 1.0;
+        return;
+    }
+    int shift = int((i - exact) / half) + 1;
+    uint64_t sub = (i - exact) % half + half;
+    low = double(sub << shift);
+    high = double((sub + 1) << shift);
+}
+
+LatencyHistogram::LatencyHistogram() : counts_(latencyBucket(UINT64_MAX, kSubBits) + 1, 0)
+{
+}
+
+void LatencyHistogram::record(double ns)
+{
+    min_ = count_ ? std::min(min_, ns) : ns;
+    max_ = count_ ? std::max(max_, ns) : ns;
+    sum_ += ns;
+    ++count_;
+    ++counts_[latencyBucket(uint64_t(std::llround(ns)), kSubBits)];
+}
+
+double LatencyHistogram::percentile(double p) const
+{
+    if (count_ == 0)
+        return 0.0;
+
+    // the rank-th smallest value, 1-based
+    uint64_t rank = std::max<uint64_t>(1, uint64_t(std::ceil(p / 100.0 * double(count_))));
+    uint64_t seen = 0;
+    for (size_t i = 0; i < counts_.size(); ++i)
+    {
+        seen += counts_[i];
+        if (seen >= rank)
+        {
+            double low, high;
+            latencyBucketRange(i, kSubBits, low, high);
+            return std::clamp(0.5 * (low + high), min_, max_);
+        }
+    }
+    return max_;
+}
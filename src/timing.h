@@ -0,0 +1,121 @@
+#pragma once
+
+// Repetition statistics for the benchmark: robust summaries of timing samples, and per-call latency
+// timing (--mode=latency).
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define TIMING_RDTSCP 1
+#elif defined(_M_X64) || defined(_M_IX86)
+#include <intrin.h>
+#define TIMING_RDTSCP 1
+#else
+#define TIMING_RDTSCP 0
+#endif
+
+// Summary of one set of repetitions (same units as the samples).
+struct SampleStats
+{
+    size_t count = 0;
+    double median = 0.0;
+    double mad = 0.0; // median absolute deviation from the median
+    double min = 0.0;
+    double max = 0.0;
+
+    // Distribution-free confidence interval for the median, from order statistics. 'ciLevel' is
+    // the coverage actually achieved: with few samples it can fall short of the level asked for,
+    // in which case the interval is [min, max].
+    double ciLow = 0.0;
+    double ciHigh = 0.0;
+    double ciLevel = 0.0;
+};
+
+SampleStats summarize(std::vector<double> samples, double confidence = 0.95);
+
+// Median of 'values' (reorders them).
+double median(std::vector<double> &values);
+
+// One-sided Mann-Whitney U test: how likely, if 'a' and 'b' came from the same distribution, 'a'
+// would beat 'b' (a[i] > b[j], ties counting half) in at least as many pairs as it does. Exact for
+// small samples, normal approximation for large ones.
+double mannWhitneyGreater(const std::vector<double> &a, const std::vector<double> &b);
+
+// Timestamps around one call: rdtscp where the CPU has it, otherwise steady_clock. The constructor
+// calibrates ticks against steady_clock and measures the cost of a start/stop pair with nothing
+// between them, which 'ns' then takes off every interval.
+class CallTimer
+{
+  public:
+    CallTimer();
+
+    uint64_t start() const
+    {
+#if TIMING_RDTSCP
+        // keep earlier work from drifting past the read, and the call from starting before it
+        _mm_lfence();
+        uint64_t t = __rdtsc();
+        _mm_lfence();
+        return t;
+#else
+        return uint64_t(std::chrono::steady_clock::now().time_since_epoch().count());
+#endif
+    }
+
+    uint64_t stop() const
+    {
+#if TIMING_RDTSCP
+        // rdtscp waits for the call to finish; the fence keeps later work from starting first
+        unsigned aux;
+        uint64_t t = __rdtscp(&aux);
+        _mm_lfence();
+        return t;
+#else
+        return uint64_t(std::chrono::steady_clock::now().time_since_epoch().count());
+#endif
+    }
+
+    // nanoseconds from 'begin' to 'end', less the timer's own overhead (never below zero)
+    double ns(uint64_t begin, uint64_t end) const;
+
+    const char *source() const { return TIMING_RDTSCP ? "rdtscp" : "steady_clock"; }
+    double ticksPerNs() const { return ticksPerNs_; }
+    double overheadNs() const { return overheadNs_; }
+
+  private:
+    double ticksPerNs_ = 1.0;
+    double overheadNs_ = 0.0;
+};
+
+// Log-linear histogram of latencies in nanoseconds, in the manner of HdrHistogram: exact below 128,
+// then 64 buckets per power of two, so any recorded value is known to within 1/64 (about 1.6%).
+// Fixed size, whatever the range: recording is a shift and an increment.
+class LatencyHistogram
+{
+  public:
+    LatencyHistogram();
+
+    void record(double ns);
+
+    uint64_t count() const { return count_; }
+    double min() const { return min_; }
+    double max() const { return max_; }
+    double mean() const { return count_ ? sum_ / double(count_) : 0.0; }
+
+    // The value 'p' percent of the recorded values are at or below (0 <= p <= 100), as the midpoint
+    // of its bucket, clamped to the recorded min and max.
+    double percentile(double p) const;
+
+  private:
+    static constexpr int kSubBits = 7; // 2^7 = 128 exact values, then 64 per power of two
+
+    std::vector<uint64_t> counts_;
+    uint64_t count_ = 0;
+    double sum_ = 0.0;
+    double min_ = 0.0;
+    double max_ = 0.0;
+};